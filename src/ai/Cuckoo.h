@@ -0,0 +1,123 @@
+#pragma once
+
+#include "src/bitboard/Magic.h"
+#include "src/bitboard/Zobrist.h"
+#include "src/core/types.h"
+
+#include <array>
+
+/**
+ * Cuckoo hash tables of every reversible move: a non-pawn piece moving between two squares it
+ * attacks on an empty board. Keys are the change in position hash the move causes, so the
+ * difference between two positions' hashes finds the move that connects them, if there is one
+ *
+ * https://marcelk.net/2013-04-06/paper/upcoming-rep-v2.pdf
+ */
+namespace Cuckoo {
+
+constexpr int SIZE = 1 << 13;
+
+inline constexpr int h1(uint64_t key) {
+    return key & (SIZE - 1);
+}
+
+inline constexpr int h2(uint64_t key) {
+    return (key >> 16) & (SIZE - 1);
+}
+
+struct Tables {
+    // N.B: 0 marks an empty slot
+    std::array<uint64_t, SIZE> keys {};
+
+    // the two squares of each move, in no particular order
+    std::array<Square, SIZE> squares1 {};
+    std::array<Square, SIZE> squares2 {};
+};
+
+inline constexpr Bitboard getEmptyBoardAttacks(PieceType pt, Square sq) {
+    switch (pt) {
+        case KNIGHT: return KNIGHT_MASKS[sq];
+        case BISHOP: return Magic::computeBishopMovesNaively(sq, 0);
+        case ROOK: return Magic::computeRookMovesNaively(sq, 0);
+        case QUEEN:
+            return Magic::computeBishopMovesNaively(sq, 0) | Magic::computeRookMovesNaively(sq, 0);
+        case KING: return KING_MASKS[sq];
+        default: return 0;
+    }
+}
+
+inline constexpr Tables createTables() {
+    Tables t;
+
+    for (Piece p : ALL_PIECES) {
+        if (pieceToPT(p) == PAWN) {
+            continue;
+        }
+
+        for (Square s1 : ALL_SQUARES) {
+            const Bitboard attacks = getEmptyBoardAttacks(pieceToPT(p), s1);
+
+            // each pair only once, since both directions of a move have the same key
+            for (int s = s1 + 1; s < NO_SQ; s++) {
+                if (!(attacks & (1ull << s))) {
+                    continue;
+                }
+
+                uint64_t key = Zobrist::getPieceSquareHash(p, s1) ^
+                               Zobrist::getPieceSquareHash(p, Square(s)) ^
+                               Zobrist::getSideToMoveHash();
+                Square a = s1, b = Square(s);
+
+                // insert, evicting whatever is in the way to its other slot until one is empty
+                int i = h1(key);
+                while (true) {
+                    const uint64_t evictedKey = t.keys[i];
+                    const Square evictedA = t.squares1[i], evictedB = t.squares2[i];
+                    t.keys[i] = key;
+                    t.squares1[i] = a;
+                    t.squares2[i] = b;
+
+                    if (evictedKey == 0) {
+                        break;
+                    }
+
+                    key = evictedKey;
+                    a = evictedA;
+                    b = evictedB;
+                    i = i == h1(key) ? h2(key) : h1(key);
+                }
+            }
+        }
+    }
+
+    return t;
+}
+
+inline constexpr Tables tables = createTables();
+
+// returns the index of the move whose key is moveKey, or -1 if there is none
+inline constexpr int find(uint64_t moveKey) {
+    if (tables.keys[h1(moveKey)] == moveKey) {
+        return h1(moveKey);
+    }
+    if (tables.keys[h2(moveKey)] == moveKey) {
+        return h2(moveKey);
+    }
+    return -1;
+}
+
+// squares strictly between two squares on a line, or none if they don't share one
+inline Bitboard getSquaresBetween(Square s1, Square s2) {
+    const Bitboard b1 = 1ull << s1, b2 = 1ull << s2;
+
+    if (rankOf(s1) == rankOf(s2) || fileOf(s1) == fileOf(s2)) {
+        return Magic::getRookAttacks(s1, b2) & Magic::getRookAttacks(s2, b1);
+    }
+    if (getSlashDiagonalIndex(s1) == getSlashDiagonalIndex(s2) ||
+        getBackslashDiagonalIndex(s1) == getBackslashDiagonalIndex(s2)) {
+        return Magic::getBishopAttacks(s1, b2) & Magic::getBishopAttacks(s2, b1);
+    }
+    return 0;
+}
+
+}  // namespace Cuckoo
@@ -1,8 +1,7 @@
 #include "Engine.h"
 
 #include "src/core/Notation.h"
-
-#include <iostream>
+#include "src/core/UciOutput.h"
 
 Engine::Engine(SearchStopper *searchStopper)
     : searcher(searchStopper) {}
@@ -11,26 +10,82 @@ void Engine::setSearchStopper(SearchStopper *searchStopper) {
     searcher.setStopper(searchStopper);
 }
 
+void Engine::setTimeManager(TimeManager *timeManager) {
+    searcher.setTimeManager(timeManager);
+}
+
 void Engine::addToHashHistory(uint64_t posHash) {
     searcher.addToRepetitionTable(posHash);
+    gamePly++;
 }
 
 void Engine::clearHistory() {
     searcher.clearRepetitionTable();
+    gamePly = 0;
+}
+
+void Engine::setBookFiles(const std::string &files) {
+    openingBook.setFiles(files);
+}
+
+void Engine::setBookDepth(int plies) {
+    openingBook.setMaxPly(plies);
+}
+
+void Engine::setSearchMoves(const std::vector<Move> &moves) {
+    searcher.setSearchMoves(moves);
+}
+
+void Engine::setMultiPV(int lines) {
+    searcher.setMultiPV(lines);
+}
+
+void Engine::setHashSize(size_t sizeMb) {
+    searcher.setHashSize(sizeMb);
+}
+
+void Engine::clearHash() {
+    searcher.clearHash();
+}
+
+bool Engine::saveHash(const std::string &path) const {
+    return searcher.saveHash(path);
+}
+
+bool Engine::loadHash(const std::string &path) {
+    return searcher.loadHash(path);
+}
+
+bool Engine::shareHash(const std::string &name) {
+    return searcher.shareHash(name);
+}
+
+void Engine::newGame() {
+    openingBook.reset();
+
+    // N.B: another process may be in the middle of its own game; "Clear Hash" still clears it
+    if (!searcher.isHashShared()) {
+        searcher.clearHash();
+    }
 }
 
 void Engine::abortSearch() {
     searcher.abortSearch();
 }
 
+void Engine::resetSearchStopper() {
+    searcher.resetStopper();
+}
+
 Move Engine::getMove(Position &pos) {
     return getMove(pos, MAX_PLY);
 }
 
 Move Engine::getMove(Position &pos, int depth) {
-    Move move = openingBook.getMove(pos);
+    Move move = openingBook.probe(pos, gamePly);
     if (move != Move::none()) {
-        std::cout << "info bookmove " << Notation::moveToUci(move) << std::endl;
+        UciOutput() << "info bookmove " << Notation::moveToUci(move);
+        ponderMove = Move::none();
         return move;
     }
 
@@ -38,5 +93,11 @@ Move Engine::getMove(Position &pos, int depth) {
 }
 
 Move Engine::getSearchedMove(Position &pos, int depth) {
-    return searcher.run(pos, depth);
+    const Move move = searcher.run(pos, depth);
+    ponderMove = searcher.getPonderMove();
+    return move;
+}
+
+Move Engine::getPonderMove() const {
+    return ponderMove;
 }
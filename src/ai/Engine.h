@@ -1,6 +1,6 @@
 #pragma once
 
-#include "src/ai/PolyglotBook.h"
+#include "src/ai/OpeningBook.h"
 #include "src/ai/search/Searcher.h"
 #include "src/core/Position.h"
 
@@ -8,19 +8,57 @@ class Engine {
    private:
     Searcher searcher;
 
-    PolyglotBook openingBook;
+    OpeningBook openingBook;
+
+    // number of moves played in the current game, for limiting book depth
+    int gamePly = 0;
+
+    // expected reply to the last move returned, if it was searched
+    Move ponderMove = Move::none();
 
    public:
     Engine(SearchStopper *searchStopper);
 
     void setSearchStopper(SearchStopper *searchStopper);
 
+    void setTimeManager(TimeManager *timeManager);
+
     void addToHashHistory(uint64_t posHash);
 
     void clearHistory();
 
+    // N.B: books are loaded lazily, on the first book probe after this
+    void setBookFiles(const std::string &files);
+
+    void setBookDepth(int plies);
+
+    // restricts searches to these root moves; empty searches every legal move
+    void setSearchMoves(const std::vector<Move> &moves);
+
+    void setMultiPV(int lines);
+
+    void setHashSize(size_t sizeMb);
+
+    void clearHash();
+
+    // saves or restores the hash table, e.g. to resume a long analysis; false if it failed
+    bool saveHash(const std::string &path) const;
+
+    bool loadHash(const std::string &path);
+
+    // puts the hash table in a shared memory segment other processes can use, or takes it back
+    // out if name is empty; false if it failed
+    bool shareHash(const std::string &name);
+
+    // forgets everything learned from previous games: the book's state and the hash table, unless
+    // other processes share it
+    void newGame();
+
     void abortSearch();
 
+    // readies the search stopper; call before every getMove, on the thread that sends stops
+    void resetSearchStopper();
+
     Move getMove(Position &pos);
 
     /**
@@ -34,4 +72,7 @@ class Engine {
 
     // same as getMove but never queries openingBook
     Move getSearchedMove(Position &pos, int depth);
+
+    // the move to ponder on after the last move returned, or Move::none() if there isn't one
+    Move getPonderMove() const;
 };
@@ -0,0 +1,178 @@
+#pragma once
+
+// Tunable evaluation parameters. This file is regenerated by the tune target, so keep hand edits
+// in the same format. PSQTs are written from white's perspective; Evaluator mirrors them for black
+
+#include "src/core/types.h"
+
+#include <array>
+
+namespace EvalParams {
+
+// PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING
+constexpr std::array<Eval, NO_PT> MATERIAL_VALUES = {100, 300, 320, 500, 900, 0};
+
+// clang-format off
+constexpr std::array<std::array<Eval, NO_SQ>, NO_PT> MIDDLEGAME_PSQT = {
+    // PAWN
+    std::array {
+     +00, +00, +00, +00, +00, +00, +00, +00,
+     +50, +50, +50, +50, +50, +50, +50, +50,
+     +10, +10, +20, +30, +30, +20, +10, +10,
+     +05, +05, +10, +25, +25, +10, +05, +05,
+     +00, +00, +00, +20, +20, +00, +00, +00,
+     +05, -05, -10, +00, +00, -10, -05, +05,
+     +05, +10, +10, -20, -20, +10, +10, +05,
+     +00, +00, +00, +00, +00, +00, +00, +00
+    },
+    // KNIGHT
+    std::array {
+     -50, -40, -30, -30, -30, -30, -40, -50,
+     -40, -20, +00, +00, +00, +00, -20, -40,
+     -30, +00, +10, +15, +15, +10, +00, -30,
+     -30, +05, +15, +20, +20, +15, +05, -30,
+     -30, +00, +15, +20, +20, +15, +00, -30,
+     -30, +05, +10, +15, +15, +10, +05, -30,
+     -40, -20, +00, +05, +05, +00, -20, -40,
+     -50, -40, -30, -30, -30, -30, -40, -50
+    },
+    // BISHOP
+    std::array {
+     -20, -10, -10, -10, -10, -10, -10, -20,
+     -10, +00, +00, +00, +00, +00, +00, -10,
+     -10, +00, +05, +10, +10, +05, +00, -10,
+     -10, +05, +05, +10, +10, +05, +05, -10,
+     -10, +00, +10, +10, +10, +10, +00, -10,
+     -10, +10, +10, +10, +10, +10, +10, -10,
+     -10, +05, +00, +00, +00, +00, +05, -10,
+     -20, -10, -10, -10, -10, -10, -10, -20
+    },
+    // ROOK
+    std::array {
+     +00, +00, +00, +00, +00, +00, +00, +00,
+     +05, +10, +10, +10, +10, +10, +10, +05,
+     -05, +00, +00, +00, +00, +00, +00, -05,
+     -05, +00, +00, +00, +00, +00, +00, -05,
+     -05, +00, +00, +00, +00, +00, +00, -05,
+     -05, +00, +00, +00, +00, +00, +00, -05,
+     -05, +00, +00, +00, +00, +00, +00, -05,
+     +00, +00, +00, +05, +05, +00, +00, +00
+    },
+    // QUEEN
+    std::array {
+     -15, -10, -10, -05, -05, -10, -10, -15,
+     -10, +05, +00, +00, +00, +00, +00, -10,
+     -10, +05, +05, +05, +05, +05, +00, -10,
+     +00, +00, +05, +05, +05, +05, +00, -05,
+     -05, +00, +05, +05, +05, +05, +00, -05,
+     -10, +00, +05, +05, +05, +05, +00, -10,
+     -10, +00, +00, +00, +00, +00, +00, -10,
+     -15, -10, -10, -05, -05, -10, -10, -15
+    },
+    // KING
+    std::array {
+     -30, -40, -40, -50, -50, -40, -40, -30,
+     -30, -40, -40, -50, -50, -40, -40, -30,
+     -30, -40, -40, -50, -50, -40, -40, -30,
+     -30, -40, -40, -50, -50, -40, -40, -30,
+     -20, -30, -30, -40, -40, -30, -30, -20,
+     -10, -20, -20, -20, -20, -20, -20, -10,
+     +20, +20, +00, +00, +00, +00, +20, +20,
+     +20, +30, +10, +00, +00, +10, +30, +20
+    }
+};
+
+constexpr std::array<std::array<Eval, NO_SQ>, NO_PT> ENDGAME_PSQT = {
+    // PAWN
+    std::array {
+     +00, +00, +00, +00, +00, +00, +00, +00,
+     +80, +80, +80, +80, +80, +80, +80, +80,
+     +50, +50, +50, +50, +50, +50, +50, +50,
+     +30, +30, +30, +30, +30, +30, +30, +30,
+     +20, +20, +20, +20, +20, +20, +20, +20,
+     +10, +10, +10, +10, +10, +10, +10, +10,
+     +10, +10, +10, +10, +10, +10, +10, +10,
+     +00, +00, +00, +00, +00, +00, +00, +00
+    },
+    // KNIGHT
+    std::array {
+     -50, -40, -30, -30, -30, -30, -40, -50,
+     -40, -20, +00, +00, +00, +00, -20, -40,
+     -30, +00, +10, +15, +15, +10, +00, -30,
+     -30, +05, +15, +20, +20, +15, +05, -30,
+     -30, +00, +15, +20, +20, +15, +00, -30,
+     -30, +05, +10, +15, +15, +10, +05, -30,
+     -40, -20, +00, +05, +05, +00, -20, -40,
+     -50, -40, -30, -30, -30, -30, -40, -50
+    },
+    // BISHOP
+    std::array {
+     -20, -10, -10, -10, -10, -10, -10, -20,
+     -10, +00, +00, +00, +00, +00, +00, -10,
+     -10, +00, +05, +10, +10, +05, +00, -10,
+     -10, +05, +05, +10, +10, +05, +05, -10,
+     -10, +00, +10, +10, +10, +10, +00, -10,
+     -10, +10, +10, +10, +10, +10, +10, -10,
+     -10, +05, +00, +00, +00, +00, +05, -10,
+     -20, -10, -10, -10, -10, -10, -10, -20
+    },
+    // ROOK
+    std::array {
+     +00, +00, +00, +00, +00, +00, +00, +00,
+     +05, +10, +10, +10, +10, +10, +10, +05,
+     -05, +00, +00, +00, +00, +00, +00, -05,
+     -05, +00, +00, +00, +00, +00, +00, -05,
+     -05, +00, +00, +00, +00, +00, +00, -05,
+     -05, +00, +00, +00, +00, +00, +00, -05,
+     -05, +00, +00, +00, +00, +00, +00, -05,
+     +00, +00, +00, +05, +05, +00, +00, +00
+    },
+    // QUEEN
+    std::array {
+     -15, -10, -10, -05, -05, -10, -10, -15,
+     -10, +05, +00, +00, +00, +00, +00, -10,
+     -10, +05, +05, +05, +05, +05, +00, -10,
+     +00, +00, +05, +05, +05, +05, +00, -05,
+     -05, +00, +05, +05, +05, +05, +00, -05,
+     -10, +00, +05, +05, +05, +05, +00, -10,
+     -10, +00, +00, +00, +00, +00, +00, -10,
+     -15, -10, -10, -05, -05, -10, -10, -15
+    },
+    // KING
+    std::array {
+     -20, -10, -10, -10, -10, -10, -10, -20,
+     -05, +00, +05, +05, +05, +05, +00, -05,
+     -10, -05, +20, +30, +30, +20, -05, -10,
+     -15, -10, +35, +45, +45, +35, -10, -15,
+     -20, -15, +30, +40, +40, +30, -15, -20,
+     -25, -20, +20, +25, +25, +20, -20, -25,
+     -30, -25, +00, +00, +00, +00, -25, -30,
+     -50, -30, -30, -30, -30, -30, -30, -50
+    }
+};
+// clang-format on
+
+// N.B: Protected passed pawns reward the sum of these bonuses
+constexpr Eval PASSED_PAWN_BONUS = 10;
+constexpr Eval PROTECTED_PASSED_PAWN_BONUS = 15;
+
+// N.B: This gets multiplied by the number of pawns doubled on a file
+constexpr Eval DOUBLED_PAWNS_PENALTY = 10;
+
+// N.B: Rooks on open files reward the sum of these bonuses
+constexpr Eval SEMI_OPEN_FILE_BONUS = 30;
+constexpr Eval OPEN_FILE_BONUS = 20;
+
+// N.B: This gets multiplied by how many king moves closer than 7 the two kings are
+constexpr Eval KING_DISTANCE_BONUS = 5;
+
+// N.B: These get multiplied by the number of safe squares a piece attacks
+// PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING
+constexpr std::array<Eval, NO_PT> MOBILITY_BONUS = {0, 4, 4, 2, 1, 0};
+
+// N.B: These get multiplied by the number of squares around the enemy king a piece attacks,
+// then scaled down as the game approaches the endgame
+// PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING
+constexpr std::array<Eval, NO_PT> KING_ATTACK_BONUS = {2, 6, 6, 8, 10, 0};
+
+}  // namespace EvalParams
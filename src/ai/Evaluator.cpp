@@ -7,8 +7,7 @@
 
 #include <cmath>
 
-// the higher this weight, the closer we are to the endgame
-float Evaluator::getEndgameWeight(Position &pos) const {
+float Evaluator::getEndgameWeight(const Position &pos) {
     static constexpr float MAX_NONPAWNS = 14.0f;
 
     int numNonPawnPieces = 0;
@@ -22,22 +21,18 @@ float Evaluator::getEndgameWeight(Position &pos) const {
 }
 
 Eval Evaluator::getPsqtEval(float endgameWeight, Piece p, Square sq) const {
-    static constexpr float WEIGHT = 0.5f;
-
     const int eg = int(endgameWeight * 256);
     const int mg = 256 - eg;
 
     const Eval mid = MIDDLEGAME_PSQT[p][sq];
     const Eval end = ENDGAME_PSQT[p][sq];
 
-    return WEIGHT * (mid * mg + end * eg) / 256;
+    return PSQT_WEIGHT * (mid * mg + end * eg) / 256;
 }
 
 Eval Evaluator::getKingDistanceEval(float endgameWeight, Position &pos) const {
-    static constexpr float WEIGHT = 5.0f;
-
     // hard cutoff
-    if (endgameWeight <= 0.6f) {
+    if (endgameWeight <= KING_DISTANCE_CUTOFF) {
         return 0;
     }
 
@@ -51,12 +46,37 @@ Eval Evaluator::getKingDistanceEval(float endgameWeight, Position &pos) const {
 
     // in endgames, favor moving the kings towards each other
     // note that the max distance on a 8x8 board is 7
-    return WEIGHT * (7 - kingDist);
+    return EvalParams::KING_DISTANCE_BONUS * (7 - kingDist);
+}
+
+Eval Evaluator::getMobilityEval(const AttackMap &attackMap) const {
+    Eval eval = 0;
+    for (PieceType pt : PIECE_TYPES) {
+        eval += EvalParams::MOBILITY_BONUS[pt] *
+                (attackMap.mobility[WHITE][pt] - attackMap.mobility[BLACK][pt]);
+    }
+    return eval;
+}
+
+Eval Evaluator::getKingSafetyEval(float endgameWeight, const AttackMap &attackMap) const {
+    // attacks on the king matter less as material comes off the board
+    const int mg = 256 - int(endgameWeight * 256);
+
+    Eval eval = 0;
+    for (PieceType pt : PIECE_TYPES) {
+        eval += EvalParams::KING_ATTACK_BONUS[pt] *
+                (attackMap.kingZoneAttacks[WHITE][pt] - attackMap.kingZoneAttacks[BLACK][pt]);
+    }
+    return eval * mg / 256;
+}
+
+Eval Evaluator::run(Position &pos) const {
+    return run(pos, AttackMap(pos));
 }
 
 // the higher the score, the better for position is for pos.getSideToMove()
 // and vice versa
-Eval Evaluator::run(Position &pos) const {
+Eval Evaluator::run(Position &pos, const AttackMap &attackMap) const {
     Eval totalEval = 0;
     Color side = pos.getSideToMove();
     float endgameWeight = getEndgameWeight(pos);
@@ -70,49 +90,49 @@ Eval Evaluator::run(Position &pos) const {
     // WP
     forEachSquare(whitePawns, [&](Square sq) {
         // material value + PSQT bonus
-        totalEval += (ptValues[PAWN] + getPsqtEval(endgameWeight, WP, sq));
+        totalEval += (EvalParams::MATERIAL_VALUES[PAWN] + getPsqtEval(endgameWeight, WP, sq));
 
         // passed pawn bonus
         if ((PASSED_PAWN_BLOCKER_MASKS[WHITE][sq] & blackPawns) == 0) {
-            totalEval += PASSED_PAWN_BONUS;
+            totalEval += EvalParams::PASSED_PAWN_BONUS;
 
             // pawn-protected passed pawn bonus
             if (PAWN_ATTACK_MASKS[BLACK][sq] & whitePawns) {
-                totalEval += PROTECTED_PASSED_PAWN_BONUS;
+                totalEval += EvalParams::PROTECTED_PASSED_PAWN_BONUS;
             }
         }
 
         // doubled pawns penalty
         int numPawnsOnFile = getBitCount(FILE_MASKS[fileOf(sq)] & whitePawns);
         if (numPawnsOnFile > 1) {
-            totalEval -= (numPawnsOnFile * DOUBLED_PAWNS_PENALTY);
+            totalEval -= (numPawnsOnFile * EvalParams::DOUBLED_PAWNS_PENALTY);
         }
     });
 
     // WN
     forEachSquare(pos.getPieceBB(WN), [&](Square sq) {
         // material value + PSQT bonus
-        totalEval += (ptValues[KNIGHT] + getPsqtEval(endgameWeight, WN, sq));
+        totalEval += (EvalParams::MATERIAL_VALUES[KNIGHT] + getPsqtEval(endgameWeight, WN, sq));
     });
 
     // WB
     forEachSquare(pos.getPieceBB(WB), [&](Square sq) {
         // material value + PSQT bonus
-        totalEval += (ptValues[BISHOP] + getPsqtEval(endgameWeight, WB, sq));
+        totalEval += (EvalParams::MATERIAL_VALUES[BISHOP] + getPsqtEval(endgameWeight, WB, sq));
     });
 
     // WR
     forEachSquare(pos.getPieceBB(WR), [&](Square sq) {
         // material value + PSQT bonus
-        totalEval += (ptValues[ROOK] + getPsqtEval(endgameWeight, WR, sq));
+        totalEval += (EvalParams::MATERIAL_VALUES[ROOK] + getPsqtEval(endgameWeight, WR, sq));
 
         // semi-open file bonus
         if ((FILE_MASKS[fileOf(sq)] & blackPawns) == 0) {
-            totalEval += SEMI_OPEN_FILE_BONUS;
+            totalEval += EvalParams::SEMI_OPEN_FILE_BONUS;
 
             // open file bonus
             if ((FILE_MASKS[fileOf(sq)] & (whitePawns | blackPawns)) == 0) {
-                totalEval += OPEN_FILE_BONUS;
+                totalEval += EvalParams::OPEN_FILE_BONUS;
             }
         }
     });
@@ -120,61 +140,61 @@ Eval Evaluator::run(Position &pos) const {
     // WQ
     forEachSquare(pos.getPieceBB(WQ), [&](Square sq) {
         // material value + PSQT bonus
-        totalEval += (ptValues[QUEEN] + getPsqtEval(endgameWeight, WQ, sq));
+        totalEval += (EvalParams::MATERIAL_VALUES[QUEEN] + getPsqtEval(endgameWeight, WQ, sq));
     });
 
     // WK
     forEachSquare(pos.getPieceBB(WK), [&](Square sq) {
-        // material value + PSQT bonus
-        totalEval += (ptValues[KING] + getPsqtEval(endgameWeight, WK, sq));
+        // PSQT bonus only; both kings are always on the board
+        totalEval += getPsqtEval(endgameWeight, WK, sq);
     });
 
     // BP
     forEachSquare(blackPawns, [&](Square sq) {
         // material value + PSQT bonus
-        totalEval -= (ptValues[PAWN] + getPsqtEval(endgameWeight, BP, sq));
+        totalEval -= (EvalParams::MATERIAL_VALUES[PAWN] + getPsqtEval(endgameWeight, BP, sq));
 
         // passed pawn bonus
         if ((PASSED_PAWN_BLOCKER_MASKS[BLACK][sq] & whitePawns) == 0) {
-            totalEval -= PASSED_PAWN_BONUS;
+            totalEval -= EvalParams::PASSED_PAWN_BONUS;
 
             // pawn-protected passed pawn bonus
             if (PAWN_ATTACK_MASKS[WHITE][sq] & blackPawns) {
-                totalEval -= PROTECTED_PASSED_PAWN_BONUS;
+                totalEval -= EvalParams::PROTECTED_PASSED_PAWN_BONUS;
             }
         }
 
         // doubled pawns penalty
-        int numPawnsOnFile = getBitCount(FILE_MASKS[fileOf(sq)] & whitePawns);
+        int numPawnsOnFile = getBitCount(FILE_MASKS[fileOf(sq)] & blackPawns);
         if (numPawnsOnFile > 1) {
-            totalEval += (numPawnsOnFile * DOUBLED_PAWNS_PENALTY);
+            totalEval += (numPawnsOnFile * EvalParams::DOUBLED_PAWNS_PENALTY);
         }
     });
 
     // BN
     forEachSquare(pos.getPieceBB(BN), [&](Square sq) {
         // material value + PSQT bonus
-        totalEval -= (ptValues[KNIGHT] + getPsqtEval(endgameWeight, BN, sq));
+        totalEval -= (EvalParams::MATERIAL_VALUES[KNIGHT] + getPsqtEval(endgameWeight, BN, sq));
     });
 
     // BB
     forEachSquare(pos.getPieceBB(BB), [&](Square sq) {
         // material value + PSQT bonus
-        totalEval -= (ptValues[BISHOP] + getPsqtEval(endgameWeight, BB, sq));
+        totalEval -= (EvalParams::MATERIAL_VALUES[BISHOP] + getPsqtEval(endgameWeight, BB, sq));
     });
 
     // BR
     forEachSquare(pos.getPieceBB(BR), [&](Square sq) {
         // material value + PSQT bonus
-        totalEval -= (ptValues[ROOK] + getPsqtEval(endgameWeight, BR, sq));
+        totalEval -= (EvalParams::MATERIAL_VALUES[ROOK] + getPsqtEval(endgameWeight, BR, sq));
 
         // semi-open file bonus
         if ((FILE_MASKS[fileOf(sq)] & whitePawns) == 0) {
-            totalEval -= SEMI_OPEN_FILE_BONUS;
+            totalEval -= EvalParams::SEMI_OPEN_FILE_BONUS;
 
             // open file bonus
             if ((FILE_MASKS[fileOf(sq)] & (whitePawns | blackPawns)) == 0) {
-                totalEval -= OPEN_FILE_BONUS;
+                totalEval -= EvalParams::OPEN_FILE_BONUS;
             }
         }
     });
@@ -182,13 +202,13 @@ Eval Evaluator::run(Position &pos) const {
     // BQ
     forEachSquare(pos.getPieceBB(BQ), [&](Square sq) {
         // material value + PSQT bonus
-        totalEval -= (ptValues[QUEEN] + getPsqtEval(endgameWeight, BQ, sq));
+        totalEval -= (EvalParams::MATERIAL_VALUES[QUEEN] + getPsqtEval(endgameWeight, BQ, sq));
     });
 
     // BK
     forEachSquare(pos.getPieceBB(BK), [&](Square sq) {
-        // material value + PSQT bonus
-        totalEval -= (ptValues[KING] + getPsqtEval(endgameWeight, BK, sq));
+        // PSQT bonus only; both kings are always on the board
+        totalEval -= getPsqtEval(endgameWeight, BK, sq);
     });
 
     ////////// END PIECE SCORING BLOCK //////////
@@ -196,6 +216,10 @@ Eval Evaluator::run(Position &pos) const {
     // king distance eval
     totalEval += getKingDistanceEval(endgameWeight, pos);
 
+    // mobility and king safety eval, both read from the shared attack map
+    totalEval += getMobilityEval(attackMap);
+    totalEval += getKingSafetyEval(endgameWeight, attackMap);
+
     // branchless way of returning -eval for black and +eval for white
     return side * -totalEval + (1 - side) * totalEval;
 }
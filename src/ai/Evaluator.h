@@ -1,279 +1,31 @@
+#pragma once
+
+#include "src/ai/EvalParams.h"
+#include "src/core/AttackMap.h"
 #include "src/core/Position.h"
 #include "src/core/types.h"
 
-class Evaluator {
-   private:
-    // clang-format off
-    static constexpr std::array<std::array<Eval, NO_SQ>, NO_PIECE> MIDDLEGAME_PSQT = {
-        // WP
-        std::array {
-         +00, +00, +00, +00, +00, +00, +00, +00,
-         +50, +50, +50, +50, +50, +50, +50, +50,
-         +10, +10, +20, +30, +30, +20, +10, +10,
-         +05, +05, +10, +25, +25, +10, +05, +05,
-         +00, +00, +00, +20, +20, +00, +00, +00,
-         +05, -05, -10, +00, +00, -10, -05, +05,
-         +05, +10, +10, -20, -20, +10, +10, +05,
-         +00, +00, +00, +00, +00, +00, +00, +00
-        },
-        // WN
-        std::array {
-         -50, -40, -30, -30, -30, -30, -40, -50,
-         -40, -20, +00, +00, +00, +00, -20, -40,
-         -30, +00, +10, +15, +15, +10, +00, -30,
-         -30, +05, +15, +20, +20, +15, +05, -30,
-         -30, +00, +15, +20, +20, +15, +00, -30,
-         -30, +05, +10, +15, +15, +10, +05, -30,
-         -40, -20, +00, +05, +05, +00, -20, -40,
-         -50, -40, -30, -30, -30, -30, -40, -50
-        },
-        // WB
-        std::array {
-         -20, -10, -10, -10, -10, -10, -10, -20,
-         -10, +00, +00, +00, +00, +00, +00, -10,
-         -10, +00, +05, +10, +10, +05, +00, -10,
-         -10, +05, +05, +10, +10, +05, +05, -10,
-         -10, +00, +10, +10, +10, +10, +00, -10,
-         -10, +10, +10, +10, +10, +10, +10, -10,
-         -10, +05, +00, +00, +00, +00, +05, -10,
-         -20, -10, -10, -10, -10, -10, -10, -20
-        },
-        // WR
-        std::array {
-         +00, +00, +00, +00, +00, +00, +00, +00,
-         +05, +10, +10, +10, +10, +10, +10, +05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         +00, +00, +00, +05, +05, +00, +00, +00
-        },
-        // WQ
-        std::array {
-         -15, -10, -10, -05, -05, -10, -10, -15,
-         -10, +05, +00, +00, +00, +00, +00, -10,
-         -10, +05, +05, +05, +05, +05, +00, -10,
-         +00, +00, +05, +05, +05, +05, +00, -05,
-         -05, +00, +05, +05, +05, +05, +00, -05,
-         -10, +00, +05, +05, +05, +05, +00, -10,
-         -10, +00, +00, +00, +00, +00, +00, -10,
-         -15, -10, -10, -05, -05, -10, -10, -15
-        },
-        // WK
-        std::array {
-         -30, -40, -40, -50, -50, -40, -40, -30,
-         -30, -40, -40, -50, -50, -40, -40, -30,
-         -30, -40, -40, -50, -50, -40, -40, -30,
-         -30, -40, -40, -50, -50, -40, -40, -30,
-         -20, -30, -30, -40, -40, -30, -30, -20,
-         -10, -20, -20, -20, -20, -20, -20, -10,
-         +20, +20, +00, +00, +00, +00, +20, +20,
-         +20, +30, +10, +00, +00, +10, +30, +20
-        },
-        // BP
-        std::array {
-         +00, +00, +00, +00, +00, +00, +00, +00,
-         +05, +10, +10, -20, -20, +10, +10, +05,
-         +05, -05, -10, +00, +00, -10, -05, +05,
-         +00, +00, +00, +20, +20, +00, +00, +00,
-         +05, +05, +10, +25, +25, +10, +05, +05,
-         +10, +10, +20, +30, +30, +20, +10, +10,
-         +50, +50, +50, +50, +50, +50, +50, +50,
-         +00, +00, +00, +00, +00, +00, +00, +00
-        },
-        // BN
-        std::array {
-         -50, -40, -30, -30, -30, -30, -40, -50,
-         -40, -20, +00, +05, +05, +00, -20, -40,
-         -30, +05, +10, +15, +15, +10, +05, -30,
-         -30, +00, +15, +20, +20, +15, +00, -30,
-         -30, +05, +15, +20, +20, +15, +05, -30,
-         -30, +00, +10, +15, +15, +10, +00, -30,
-         -40, -20, +00, +00, +00, +00, -20, -40,
-         -50, -40, -30, -30, -30, -30, -40, -50
-        },
-        // BB
-        std::array {
-         -20, -10, -10, -10, -10, -10, -10, -20,
-         -10, +05, +00, +00, +00, +00, +05, -10,
-         -10, +10, +10, +10, +10, +10, +10, -10,
-         -10, +00, +10, +10, +10, +10, +00, -10,
-         -10, +05, +05, +10, +10, +05, +05, -10,
-         -10, +00, +05, +10, +10, +05, +00, -10,
-         -10, +00, +00, +00, +00, +00, +00, -10,
-         -20, -10, -10, -10, -10, -10, -10, -20
-        },
-        // BR
-        std::array {
-         +00, +00, +00, +05, +05, +00, +00, +00,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         +05, +10, +10, +10, +10, +10, +10, +05,
-         +00, +00, +00, +00, +00, +00, +00, +00
-        },
-        // BQ
-        std::array {
-         -15, -10, -10, -05, -05, -10, -10, -15,
-         -10, +05, +00, +00, +00, +00, +00, -10,
-         -10, +05, +05, +05, +05, +05, +00, -10,
-         +00, +00, +05, +05, +05, +05, +00, -05,
-         -05, +00, +05, +05, +05, +05, +00, -05,
-         -10, +00, +05, +05, +05, +05, +00, -10,
-         -10, +00, +00, +00, +00, +00, +00, -10,
-         -15, -10, -10, -05, -05, -10, -10, -15
-        },
-        // BK
-        std::array {
-         +20, +30, +10, +00, +00, +10, +30, +20,
-         +20, +20, +00, +00, +00, +00, +20, +20,
-         -10, -20, -20, -20, -20, -20, -20, -10,
-         -20, -30, -30, -40, -40, -30, -30, -20,
-         -30, -40, -40, -50, -50, -40, -40, -30,
-         -30, -40, -40, -50, -50, -40, -40, -30,
-         -30, -40, -40, -50, -50, -40, -40, -30,
-         -30, -40, -40, -50, -50, -40, -40, -30
-        }
-    };
+using PieceSquareTables = std::array<std::array<Eval, NO_SQ>, NO_PIECE>;
 
-    static constexpr std::array<std::array<Eval, NO_SQ>, NO_PIECE> ENDGAME_PSQT = {
-        // WP
-        std::array {
-         +00, +00, +00, +00, +00, +00, +00, +00,
-         +80, +80, +80, +80, +80, +80, +80, +80,
-         +50, +50, +50, +50, +50, +50, +50, +50,
-         +30, +30, +30, +30, +30, +30, +30, +30,
-         +20, +20, +20, +20, +20, +20, +20, +20,
-         +10, +10, +10, +10, +10, +10, +10, +10,
-         +10, +10, +10, +10, +10, +10, +10, +10,
-         +00, +00, +00, +00, +00, +00, +00, +00
-        },
-        // WN
-        std::array {
-         -50, -40, -30, -30, -30, -30, -40, -50,
-         -40, -20, +00, +00, +00, +00, -20, -40,
-         -30, +00, +10, +15, +15, +10, +00, -30,
-         -30, +05, +15, +20, +20, +15, +05, -30,
-         -30, +00, +15, +20, +20, +15, +00, -30,
-         -30, +05, +10, +15, +15, +10, +05, -30,
-         -40, -20, +00, +05, +05, +00, -20, -40,
-         -50, -40, -30, -30, -30, -30, -40, -50
-        },
-        // WB
-        std::array {
-         -20, -10, -10, -10, -10, -10, -10, -20,
-         -10, +00, +00, +00, +00, +00, +00, -10,
-         -10, +00, +05, +10, +10, +05, +00, -10,
-         -10, +05, +05, +10, +10, +05, +05, -10,
-         -10, +00, +10, +10, +10, +10, +00, -10,
-         -10, +10, +10, +10, +10, +10, +10, -10,
-         -10, +05, +00, +00, +00, +00, +05, -10,
-         -20, -10, -10, -10, -10, -10, -10, -20
-        },
-        // WR
-        std::array {
-         +00, +00, +00, +00, +00, +00, +00, +00,
-         +05, +10, +10, +10, +10, +10, +10, +05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         +00, +00, +00, +05, +05, +00, +00, +00
-        },
-        // WQ
-        std::array {
-         -15, -10, -10, -05, -05, -10, -10, -15,
-         -10, +05, +00, +00, +00, +00, +00, -10,
-         -10, +05, +05, +05, +05, +05, +00, -10,
-         +00, +00, +05, +05, +05, +05, +00, -05,
-         -05, +00, +05, +05, +05, +05, +00, -05,
-         -10, +00, +05, +05, +05, +05, +00, -10,
-         -10, +00, +00, +00, +00, +00, +00, -10,
-         -15, -10, -10, -05, -05, -10, -10, -15
-        },
-        // WK
-        std::array {
-         -20, -10, -10, -10, -10, -10, -10, -20,
-         -05, +00, +05, +05, +05, +05, +00, -05, 
-         -10, -05, +20, +30, +30, +20, -05, -10,
-         -15, -10, +35, +45, +45, +35, -10, -15,
-         -20, -15, +30, +40, +40, +30, -15, -20,
-         -25, -20, +20, +25, +25, +20, -20, -25,
-         -30, -25, +00, +00, +00, +00, -25, -30,
-         -50, -30, -30, -30, -30, -30, -30, -50
-        },
-        // BP
-        std::array {
-         +00, +00, +00, +00, +00, +00, +00, +00,
-         +10, +10, +10, +10, +10, +10, +10, +10,
-         +10, +10, +10, +10, +10, +10, +10, +10,
-         +20, +20, +20, +20, +20, +20, +20, +20,
-         +30, +30, +30, +30, +30, +30, +30, +30,
-         +50, +50, +50, +50, +50, +50, +50, +50,        
-         +80, +80, +80, +80, +80, +80, +80, +80,
-         +00, +00, +00, +00, +00, +00, +00, +00,
-        },
-        // BN
-        std::array {
-         -50, -40, -30, -30, -30, -30, -40, -50,
-         -40, -20, +00, +05, +05, +00, -20, -40,
-         -30, +05, +10, +15, +15, +10, +05, -30,
-         -30, +00, +15, +20, +20, +15, +00, -30,
-         -30, +05, +15, +20, +20, +15, +05, -30,
-         -30, +00, +10, +15, +15, +10, +00, -30,
-         -40, -20, +00, +00, +00, +00, -20, -40,
-         -50, -40, -30, -30, -30, -30, -40, -50
-        },
-        // BB
-        std::array {
-         -20, -10, -10, -10, -10, -10, -10, -20,
-         -10, +05, +00, +00, +00, +00, +05, -10,
-         -10, +10, +10, +10, +10, +10, +10, -10,
-         -10, +00, +10, +10, +10, +10, +00, -10,
-         -10, +05, +05, +10, +10, +05, +05, -10,
-         -10, +00, +05, +10, +10, +05, +00, -10,
-         -10, +00, +00, +00, +00, +00, +00, -10,
-         -20, -10, -10, -10, -10, -10, -10, -20
-        },
-        // BR
-        std::array {
-         +00, +00, +00, +05, +05, +00, +00, +00,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         -05, +00, +00, +00, +00, +00, +00, -05,
-         +05, +10, +10, +10, +10, +10, +10, +05,
-         +00, +00, +00, +00, +00, +00, +00, +00
-        },
-        // BQ
-        std::array {
-         -15, -10, -10, -05, -05, -10, -10, -15,
-         -10, +05, +00, +00, +00, +00, +00, -10,
-         -10, +05, +05, +05, +05, +05, +00, -10,
-         +00, +00, +05, +05, +05, +05, +00, -05,
-         -05, +00, +05, +05, +05, +05, +00, -05,
-         -10, +00, +05, +05, +05, +05, +00, -10,
-         -10, +00, +00, +00, +00, +00, +00, -10,
-         -15, -10, -10, -05, -05, -10, -10, -15
-        },
-        // BK
-        std::array {
-         -50, -30, -30, -30, -30, -30, -30, -50,
-         -30, -25, +00, +00, +00, +00, -25, -30,
-         -25, -20, +20, +25, +25, +20, -20, -25,
-         -20, -15, +30, +40, +40, +30, -15, -20,
-         -15, -10, +35, +45, +45, +35, -10, -15,
-         -10, -05, +20, +30, +30, +20, -05, -10,
-         -05, +00, +05, +05, +05, +05, +00, -05, 
-         -20, -10, -10, -10, -10, -10, -10, -20
+// black's tables are white's flipped vertically
+inline constexpr PieceSquareTables
+expandPsqt(const std::array<std::array<Eval, NO_SQ>, NO_PT> &whiteTables) {
+    PieceSquareTables tables {};
+    for (PieceType pt : PIECE_TYPES) {
+        for (Square sq : ALL_SQUARES) {
+            tables[ptToPiece(pt, WHITE)][sq] = whiteTables[pt][sq];
+            tables[ptToPiece(pt, BLACK)][sq] = whiteTables[pt][flipRank(sq)];
         }
-    };
+    }
+    return tables;
+}
 
+class Evaluator {
+    // mirrors this class's terms when extracting features
+    friend class Tuner;
+
+   private:
+    // clang-format off
     // each entry represents a set of squares, such that if any enemy pawn appears in that set,
     // a pawn at that entry is not a passed pawn. if there is a pawn on that square and there
     // are no enemy pawns in that set, then that pawn is a passer. using the fact that pawns
@@ -302,25 +54,32 @@ class Evaluator {
     };
     // clang-format on
 
-    // N.B: Protected passed pawns reward the sum of these bonuses
-    static constexpr Eval PASSED_PAWN_BONUS = 10;
-    static constexpr Eval PROTECTED_PASSED_PAWN_BONUS = 15;
+    // PSQTs for every piece, expanded from EvalParams' white-perspective tables
+    static constexpr PieceSquareTables MIDDLEGAME_PSQT = expandPsqt(EvalParams::MIDDLEGAME_PSQT);
+    static constexpr PieceSquareTables ENDGAME_PSQT = expandPsqt(EvalParams::ENDGAME_PSQT);
 
-    // N.B: This gets multiplied by the number of pawns doubled on a file
-    static constexpr Eval DOUBLED_PAWNS_PENALTY = 10;
+    // the PSQT term is scaled down by this much before it is added to the eval
+    static constexpr float PSQT_WEIGHT = 0.5f;
 
-    // N.B: Rooks on open files reward the sum of these bonuses
-    static constexpr Eval SEMI_OPEN_FILE_BONUS = 30;
-    static constexpr Eval OPEN_FILE_BONUS = 20;
+    // the king distance term only applies once the endgame weight exceeds this
+    static constexpr float KING_DISTANCE_CUTOFF = 0.6f;
 
-    float getEndgameWeight(Position &pos) const;
+    // the higher this weight, the closer we are to the endgame
+    static float getEndgameWeight(const Position &pos);
 
     Eval getPsqtEval(float endgameWeight, Piece p, Square sq) const;
 
     Eval getKingDistanceEval(float endgameWeight, Position &pos) const;
 
+    Eval getMobilityEval(const AttackMap &attackMap) const;
+
+    Eval getKingSafetyEval(float endgameWeight, const AttackMap &attackMap) const;
+
    public:
     constexpr Evaluator() {}
 
     Eval run(Position &pos) const;
+
+    // same as run but reuses attacks the caller has already computed for this node
+    Eval run(Position &pos, const AttackMap &attackMap) const;
 };
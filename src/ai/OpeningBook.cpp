@@ -0,0 +1,87 @@
+#include "OpeningBook.h"
+
+#include "src/core/MoveList.h"
+#include "src/movegen/MoveGenerator.h"
+
+#include <sstream>
+
+OpeningBook::OpeningBook() {
+    setFiles(std::string(DEFAULT_BOOK_FILES));
+}
+
+void OpeningBook::setFiles(const std::string &files) {
+    paths.clear();
+    books.clear();
+    loaded = false;
+    outOfBook = false;
+
+    if (files == "<empty>") {
+        return;
+    }
+
+    std::stringstream ss(files);
+    std::string path;
+    while (std::getline(ss, path, ';')) {
+        if (!path.empty()) {
+            paths.push_back(path);
+        }
+    }
+}
+
+std::string OpeningBook::getFiles() const {
+    std::string files;
+    for (const std::string &path : paths) {
+        files += files.empty() ? path : ";" + path;
+    }
+    return files;
+}
+
+void OpeningBook::setMaxPly(int maxPly) {
+    this->maxPly = maxPly;
+    outOfBook = false;
+}
+
+void OpeningBook::reset() {
+    outOfBook = false;
+}
+
+void OpeningBook::load() {
+    loaded = true;
+
+    for (const std::string &path : paths) {
+        auto book = std::make_unique<PolyglotBook>(path);
+
+        // missing books are reported by PolyglotBook and skipped
+        if (book->size() > 0) {
+            books.push_back(std::move(book));
+        }
+    }
+}
+
+Move OpeningBook::probe(const Position &pos, int ply) {
+    if (outOfBook || ply >= maxPly) {
+        outOfBook = true;
+        return Move::none();
+    }
+
+    if (!loaded) {
+        load();
+    }
+
+    // N.B: move generation makes and unmakes moves, so it needs a copy it can modify
+    Position copy = pos;
+    MoveList legalMoves;
+    MoveGenerator::generateLegal(legalMoves, copy);
+
+    // N.B: key collisions and malformed entries can give illegal moves; those books are skipped
+    for (const std::unique_ptr<PolyglotBook> &book : books) {
+        const Move move = book->getMove(pos);
+        if (move != Move::none() && legalMoves.has(move)) {
+            return move;
+        }
+    }
+
+    // N.B: positions later in the game are very unlikely to transpose back into book
+    outOfBook = true;
+    return Move::none();
+}
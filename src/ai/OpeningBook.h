@@ -0,0 +1,58 @@
+#pragma once
+
+#include "src/ai/PolyglotBook.h"
+#include "src/core/Move.h"
+#include "src/core/Position.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * A list of Polyglot books queried in priority order
+ *
+ * Books are only loaded on the first probe, so constructing an Engine costs nothing. Once a probe
+ * misses, or the game is past the depth limit, the book is not probed again until reset()
+ */
+class OpeningBook {
+   private:
+    std::vector<std::string> paths;
+
+    std::vector<std::unique_ptr<PolyglotBook>> books;
+
+    bool loaded = false;
+
+    bool outOfBook = false;
+
+    // book moves are only played during the first maxPly plies of a game
+    int maxPly = DEFAULT_MAX_PLY;
+
+    void load();
+
+   public:
+    static constexpr int DEFAULT_MAX_PLY = 100;
+
+    OpeningBook();
+
+    /**
+     * Replaces the list of books, highest priority first
+     *
+     * @param files paths separated by ';'; empty or "<empty>" disables the book
+     */
+    void setFiles(const std::string &files);
+
+    std::string getFiles() const;
+
+    void setMaxPly(int maxPly);
+
+    // allows probing again, e.g. at the start of a new game
+    void reset();
+
+    /**
+     * Picks a move from the first book that has a legal one for this position
+     *
+     * @param ply number of plies played in the game so far
+     * @return the book move, or Move::none() if the game is out of book
+     */
+    Move probe(const Position &pos, int ply);
+};
@@ -1,20 +1,9 @@
 #include "PVTable.h"
 
-#include "src/core/Notation.h"
-
 #include <cassert>
-#include <sstream>
-
-std::string PVTable::getBestLine() {
-    std::ostringstream ss;
-    for (int i = 0; i < lengths[0]; i++) {
-        ss << Notation::moveToUci(table[0][i]) << " ";
-    }
-    return ss.str();
-}
 
-Move PVTable::getBestMove() {
-    return table[0][0];
+std::vector<Move> PVTable::getLine(int ply) const {
+    return std::vector<Move>(table[ply].begin() + ply, table[ply].begin() + ply + lengths[ply]);
 }
 
 void PVTable::update(const Move &m, int ply) {
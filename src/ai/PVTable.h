@@ -1,7 +1,7 @@
 #include "src/core/Move.h"
 #include "src/core/types.h"
 
-#include <string>
+#include <vector>
 
 class PVTable {
    private:
@@ -9,9 +9,8 @@ class PVTable {
     std::array<int, MAX_PLY> lengths;
 
    public:
-    std::string getBestLine();
-
-    Move getBestMove();
+    // the PV of the node at ply, starting with its best move
+    std::vector<Move> getLine(int ply) const;
 
     void update(const Move &m, int ply);
 
@@ -1,41 +1,49 @@
 #include "PolyglotBook.h"
 
-#include "src/bitboard/Magic.h"
 #include "src/bitboard/bit_tools.h"
 #include "src/core/types.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <fcntl.h>
 #include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <vector>
 
-struct PgEntry;
-
-PolyglotBook::PolyglotBook() {
-    std::ifstream file(FILE_PATH, std::ios::binary);
-
-    if (!file) {
-        std::cerr << "Failed to open book: " << FILE_PATH << "\n";
+PolyglotBook::PolyglotBook(const std::string &path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open book: " << path << "\n";
         return;
     }
 
-    PgEntry raw;
+    struct stat st;
+    const size_t n = fstat(fd, &st) == 0 ? st.st_size / sizeof(PgEntry) : 0;
 
-    while (file.read(reinterpret_cast<char *>(&raw), sizeof(raw))) {
-        PgEntry e {};
+    // N.B: mmap fails on empty files, so leave the book empty instead
+    if (n > 0) {
+        void *mapped = mmap(nullptr, n * sizeof(PgEntry), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Failed to map book: " << path << "\n";
+        } else {
+            bookEntries = static_cast<const PgEntry *>(mapped);
+            numEntries = n;
+        }
+    }
 
-        // swap bytes on little endian machines
-        e.key = swap64(raw.key);
-        e.move = swap16(raw.move);
-        e.weight = swap16(raw.weight);
-        e.learn = swap32(raw.learn);
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+}
 
-        bookEntries.push_back(e);
+PolyglotBook::~PolyglotBook() {
+    if (bookEntries != nullptr) {
+        munmap(const_cast<PgEntry *>(bookEntries), numEntries * sizeof(PgEntry));
     }
-
-    std::cout << "Loaded " << bookEntries.size() << " polyglot entries\n";
 }
 
-Move PolyglotBook::decodePgMove(const Position &pos, uint16_t pgMove) {
+Move PolyglotBook::decodePgMove(const Position &pos, uint16_t pgMove) const {
     // need to flip rank because PG orders ranks in reverse of sockfish
     const Square to = flipRank(Square(pgMove & 0x3F));
     const Square from = flipRank(Square((pgMove >> 6) & 0x3F));
@@ -58,6 +66,10 @@ Move PolyglotBook::decodePgMove(const Position &pos, uint16_t pgMove) {
         }
     }
 
+    if (p != NO_PIECE && pieceToPT(p) == PAWN && to == pos.getEpSquare()) {
+        return Move::create<Move::EN_PASSANT>(from, to);
+    }
+
     if (promo == 0) {
         return Move::create<Move::NORMAL>(from, to);
     }
@@ -65,73 +77,51 @@ Move PolyglotBook::decodePgMove(const Position &pos, uint16_t pgMove) {
     return Move::create<Move::PROMOTION>(from, to, promo);
 }
 
-uint64_t PolyglotBook::getPgHash(const Position &pos) {
-    uint64_t hash = 0;
+uint16_t PolyglotBook::encodePgMove(const Move &move) {
+    const Square from = move.getFromSquare();
+    Square to = move.getToSquare();
 
-    // ---- Pieces ----
-    for (Square sq : ALL_SQUARES) {
-        Piece p = pos.pieceAt(sq);
-        if (p != NO_PIECE) {
-            int offsetPiece = 64 * pgKindOfPiece(p) + 8 * pgRowOf(sq) + pgFileOf(sq);
-            hash ^= POLYGLOT_RANDOM[offsetPiece];
-        }
+    if (move.isCastles()) {
+        to = xyToSquare(fileOf(to) == FILE_G ? FILE_H : FILE_A, rankOf(to));
     }
 
-    // ---- Castling ----
-    CastleRights cr = pos.getCastleRights();
-
-    if (hasCastleRights(cr, WHITE_OO)) {
-        hash ^= POLYGLOT_RANDOM[768];
-    }
-    if (hasCastleRights(cr, WHITE_OOO)) {
-        hash ^= POLYGLOT_RANDOM[769];
-    }
-    if (hasCastleRights(cr, BLACK_OO)) {
-        hash ^= POLYGLOT_RANDOM[770];
-    }
-    if (hasCastleRights(cr, BLACK_OOO)) {
-        hash ^= POLYGLOT_RANDOM[771];
-    }
-
-    // ---- En Passant ----
-    Square ep = pos.getEpSquare();
-    Color side = pos.getSideToMove();
-
-    if (ep != NO_SQ) {
-        int file = pgFileOf(ep);
-
-        // Only include EP if a pawn can capture it
-        Bitboard stmPawnBB = pos.getPieceBB(ptToPiece(PAWN, side));
-        Bitboard reverseEpPawnAttacks = PAWN_ATTACK_MASKS[otherColor(side)][ep];
-        if (stmPawnBB & reverseEpPawnAttacks) {
-            hash ^= POLYGLOT_RANDOM[772 + file];
-        }
-    }
+    // need to flip rank because PG orders ranks in reverse of sockfish
+    uint16_t pgMove = flipRank(to) | (flipRank(from) << 6);
 
-    // ---- Side to move ----
-    if (side == WHITE) {
-        hash ^= POLYGLOT_RANDOM[780];
+    if (move.isPromotion()) {
+        pgMove |= move.getPromotedPieceType() << 12;
     }
 
-    return hash;
+    return pgMove;
 }
 
-std::vector<PolyglotBook::PgEntry> PolyglotBook::getPgEntries(const Position &pos) {
-    uint64_t key = getPgHash(pos);
+std::vector<PolyglotBook::PgEntry> PolyglotBook::getPgEntries(const Position &pos) const {
+    // N.B: position hashes use the Polyglot keys
+    const uint64_t key = pos.getHash();
 
     std::vector<PgEntry> bookMoves;
 
-    // use binary search?
-    for (const PgEntry &e : bookEntries) {
-        if (e.key == key) {
-            bookMoves.push_back(e);
-        }
+    // entries are sorted by key, so all of a position's entries are adjacent
+    const PgEntry *begin = bookEntries, *end = bookEntries + numEntries;
+    const PgEntry *it = std::lower_bound(begin, end, key, [](const PgEntry &e, uint64_t k) {
+        return swap64(e.key) < k;
+    });
+
+    // swap bytes on little endian machines
+    for (; it != end && swap64(it->key) == key; it++) {
+        PgEntry e {};
+        e.key = key;
+        e.move = swap16(it->move);
+        e.weight = swap16(it->weight);
+        e.learn = swap32(it->learn);
+
+        bookMoves.push_back(e);
     }
 
     return bookMoves;
 }
 
-std::vector<Move> PolyglotBook::getMoves(const Position &pos) {
+std::vector<Move> PolyglotBook::getMoves(const Position &pos) const {
     std::vector<PgEntry> pgEntries = getPgEntries(pos);
     std::vector<Move> bookMoves;
     bookMoves.reserve(pgEntries.size());
@@ -145,6 +135,10 @@ std::vector<Move> PolyglotBook::getMoves(const Position &pos) {
 }
 
 Move PolyglotBook::getMove(const Position &pos) {
+    return getMove(pos, rng);
+}
+
+Move PolyglotBook::getMove(const Position &pos, PRNG &prng) const {
     std::vector<PgEntry> pgEntries = getPgEntries(pos);
     if (pgEntries.empty()) {
         return Move::none();
@@ -158,9 +152,14 @@ Move PolyglotBook::getMove(const Position &pos) {
         totalWeight += e.weight;
     }
 
+    // every entry is unweighted; just play the first
+    if (totalWeight == 0) {
+        return decodePgMove(pos, result.move);
+    }
+
     // pick a move at random, where entries with higher weights have a higher chance of their move
     // being selected
-    int r = rng.next() % totalWeight;
+    int r = prng.next() % totalWeight;
     for (const PgEntry &e : pgEntries) {
         r -= e.weight;
         if (r < 0) {
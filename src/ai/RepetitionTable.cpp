@@ -1,20 +1,62 @@
 #include "RepetitionTable.h"
 
+#include "src/ai/Cuckoo.h"
+
+#include <algorithm>
 #include <cassert>
 
 void RepetitionTable::push(uint64_t posHash) {
     assert(index < TABLE_SIZE);
     table[index++] = posHash;
+    filter[getFilterIndex(posHash)]++;
 }
 
 void RepetitionTable::pop() {
     assert(index > 0);
     index--;
+    filter[getFilterIndex(table[index])]--;
+}
+
+bool RepetitionTable::contains(uint64_t posHash, int movesSinceCapture) const {
+    if (filter[getFilterIndex(posHash)] == 0) {
+        return false;
+    }
+
+    // the top of the stack is the previous position, and it takes at least four plies to repeat
+    const int end = std::min(movesSinceCapture, index);
+    for (int plies = 4; plies <= end; plies += 2) {
+        if (table[index - plies] == posHash) {
+            return true;
+        }
+    }
+    return false;
 }
 
-bool RepetitionTable::contains(uint64_t posHash) const {
-    for (int i = 0; i < index; i++) {
-        if (table[i] == posHash) {
+bool RepetitionTable::hasUpcomingRepetition(const Position &pos, int ply) const {
+    const uint64_t posHash = pos.getHash();
+    const Bitboard occupancy = pos.getBoard().getOccupancies();
+
+    // one move by the side to move leads to positions an odd number of plies back
+    const int end = std::min(pos.getMetadata().movesSinceCapture, index);
+    for (int plies = 3; plies <= end; plies += 2) {
+        const int i = Cuckoo::find(posHash ^ table[index - plies]);
+        if (i < 0) {
+            continue;
+        }
+
+        const Square s1 = Cuckoo::tables.squares1[i], s2 = Cuckoo::tables.squares2[i];
+        if (Cuckoo::getSquaresBetween(s1, s2) & occupancy) {
+            continue;
+        }
+
+        // the cycle is within the search tree
+        if (ply > plies) {
+            return true;
+        }
+
+        // both directions share a key, so check the piece being moved belongs to the side to move
+        const Piece moved = pos.pieceAt(pos.pieceAt(s1) == NO_PIECE ? s2 : s1);
+        if (pieceColor(moved) == pos.getSideToMove()) {
             return true;
         }
     }
@@ -23,4 +65,5 @@ bool RepetitionTable::contains(uint64_t posHash) const {
 
 void RepetitionTable::clear() {
     index = 0;
+    filter.fill(0);
 }
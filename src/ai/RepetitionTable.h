@@ -1,3 +1,7 @@
+#pragma once
+
+#include "src/core/Position.h"
+
 #include <array>
 #include <cstdint>
 
@@ -9,12 +13,38 @@ class RepetitionTable {
     std::array<uint64_t, TABLE_SIZE> table;
     int index = 0;
 
+    // Counting filter over the stack; a position can only be on the stack if its counter is
+    // nonzero, so most lookups end without scanning
+    static constexpr int FILTER_BITS = 12;
+    std::array<uint16_t, 1 << FILTER_BITS> filter = {};
+
+    static constexpr int getFilterIndex(uint64_t posHash) {
+        // N.B: the TT indexes with the low bits, so use the high ones here
+        return posHash >> (64 - FILTER_BITS);
+    }
+
    public:
+    // N.B: the stack must hold one position per ply, so push every position except the one
+    // about to be searched
     void push(uint64_t posHash);
 
     void pop();
 
-    bool contains(uint64_t posHash) const;
+    /**
+     * Checks whether the position repeats one on the stack. Only positions with the same side to
+     * move since the last irreversible move can match, so the stack is walked backward two plies
+     * at a time, for at most movesSinceCapture plies
+     */
+    bool contains(uint64_t posHash, int movesSinceCapture) const;
+
+    /**
+     * Checks whether the side to move has a move that repeats a position on the stack, using the
+     * cuckoo tables of reversible moves. Repeating a position from before the root only counts if
+     * the side to move is the one making the move
+     *
+     * @param ply distance from the root
+     */
+    bool hasUpcomingRepetition(const Position &pos, int ply) const;
 
     // consider clearing after pawn moves, captures, and castling
     void clear();
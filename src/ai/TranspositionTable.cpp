@@ -1,15 +1,128 @@
 #include "TranspositionTable.h"
 
-TranspositionTable::TranspositionTable() {
-    clear();
+#include "src/core/Position.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char FILE_MAGIC[8] = {'S', 'O', 'C', 'K', 'H', 'A', 'S', 'H'};
+constexpr uint32_t FILE_VERSION = 2;
+
+// starts every saved table; the entries follow it directly
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+
+    // a table saved by a build with a different entry layout can't be read back
+    uint32_t entrySize;
+
+    uint64_t numEntries;
+
+    // hash of the starting position, which differs if the Zobrist keys do
+    uint64_t keyCheck;
+
+    uint8_t generation;
+};
+
+// starts every shared memory segment; the entries follow it, a cache line in
+struct alignas(64) SharedHeader {
+    std::atomic<uint8_t> generation;
+};
+
+static_assert(sizeof(SharedHeader) == 64);
+
+// N.B: an atomic that takes a lock can't be shared between processes
+static_assert(std::atomic<uint8_t>::is_always_lock_free);
+
+// how long to wait for another process to finish sizing a segment it just created
+constexpr auto SHARED_SIZE_TIMEOUT = std::chrono::seconds(1);
+
+// eval in bits 0-31, depth + 1 in 32-47, flag in 48-55 and generation in 56-63, so that an empty
+// slot, which has depth -1, is all zero
+uint64_t pack(Eval eval, int depth, TTFlag flag, uint8_t generation) {
+    return uint64_t(uint32_t(eval)) | uint64_t(uint16_t(depth + 1)) << 32 |
+           uint64_t(uint8_t(flag)) << 48 | uint64_t(generation) << 56;
+}
+
+int unpackDepth(uint64_t data) {
+    return int((data >> 32) & 0xFFFF) - 1;
+}
+
+uint8_t unpackGeneration(uint64_t data) {
+    return data >> 56;
+}
+
+TTEntry unpack(uint64_t key, uint64_t data) {
+    return {key, unpackDepth(data), Eval(int32_t(uint32_t(data))), TTFlag((data >> 48) & 0xFF),
+            unpackGeneration(data)};
+}
+
+uint64_t getKeyCheck() {
+    return Position(std::string(STARTING_POSITION_FEN)).getHash();
+}
+
+// N.B: write and read may transfer less than asked, e.g. over 2 GB at once, or be interrupted
+bool writeAll(int fd, const void *data, size_t size) {
+    const char *bytes = static_cast<const char *>(data);
+    while (size > 0) {
+        const ssize_t n = write(fd, bytes, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n <= 0) {
+            return false;
+        }
+        bytes += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool readAll(int fd, void *data, size_t size) {
+    char *bytes = static_cast<char *>(data);
+    while (size > 0) {
+        const ssize_t n = read(fd, bytes, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n <= 0) {
+            return false;
+        }
+        bytes += n;
+        size -= n;
+    }
+    return true;
+}
+
+}  // namespace
+
+TranspositionTable::TranspositionTable()
+    : table(nullptr), indexMask(0), generation(&privateGeneration) {
+    allocatePrivate(DEFAULT_ENTRIES);
+}
+
+TranspositionTable::~TranspositionTable() {
+    unmapShared();
 }
 
 TTEntry TranspositionTable::lookup(uint64_t posHash, int ply, int depth) const {
-    // this needs to be a copy
-    TTEntry e = table[getIndex(posHash)];
+    // N.B: this needs to be a copy, the key check only holds for the words it was made from
+    const TTSlot slot = table[getIndex(posHash)];
+    if ((slot.check ^ slot.data) != posHash) {
+        return TTEntry {};
+    }
 
-    // only valid if keys match and depth is deep enough
-    if (e.key == posHash && e.depth >= depth) {
+    TTEntry e = unpack(posHash, slot.data);
+
+    // only valid if depth is deep enough
+    if (e.depth >= depth) {
         // adjust eval for mate scores
         if (e.eval >= MATE_BOUND) {
             e.eval += ply;
@@ -24,6 +137,14 @@ TTEntry TranspositionTable::lookup(uint64_t posHash, int ply, int depth) const {
 
 void TranspositionTable::store(
     uint64_t posHash, Eval eval, int alpha, int beta, int ply, int depth) {
+    TTSlot &slot = table[getIndex(posHash)];
+    const TTSlot old = slot;
+    const uint8_t currentGeneration = generation->load(std::memory_order_relaxed);
+    if ((old.check ^ old.data) != posHash && unpackGeneration(old.data) == currentGeneration &&
+        unpackDepth(old.data) > depth) {
+        return;
+    }
+
     // determine flag
     TTFlag flag = (eval <= alpha) ? UPPERBOUND : (eval >= beta) ? LOWERBOUND : EXACT;
 
@@ -34,9 +155,223 @@ void TranspositionTable::store(
         eval += ply;
     }
 
-    table[getIndex(posHash)] = {posHash, depth, eval, flag};
+    const uint64_t data = pack(eval, depth, flag, currentGeneration);
+    slot = {posHash ^ data, data};
+}
+
+void TranspositionTable::newSearch() {
+    generation->fetch_add(1, std::memory_order_relaxed);
+}
+
+void TranspositionTable::resize(size_t sizeMb) {
+    const size_t maxEntries = std::max<size_t>(1, (sizeMb << 20) / sizeof(TTSlot));
+
+    size_t entries = 1;
+    while (entries * 2 <= maxEntries) {
+        entries *= 2;
+    }
+
+    if (shmName.empty()) {
+        allocatePrivate(entries);
+        return;
+    }
+
+    // N.B: an existing segment keeps its size, other processes have it mapped
+    const std::string name = shmName;
+    unmapShared();
+    if (!mapShared(name, entries)) {
+        allocatePrivate(entries);
+    }
+}
+
+bool TranspositionTable::share(const std::string &name) {
+    if (name == shmName) {
+        return true;
+    }
+
+    const size_t entries = size();
+    unmapShared();
+    if (name.empty()) {
+        allocatePrivate(entries);
+        return true;
+    }
+
+    if (!mapShared(name, entries)) {
+        if (table == nullptr) {
+            allocatePrivate(entries);
+        }
+        return false;
+    }
+    return true;
+}
+
+bool TranspositionTable::isShared() const {
+    return !shmName.empty();
+}
+
+void TranspositionTable::allocatePrivate(size_t entries) {
+    // N.B: assign rather than resize so the old table's memory is released first
+    privateTable = std::vector<TTSlot>();
+    privateTable.resize(entries);
+    table = privateTable.data();
+    indexMask = entries - 1;
+}
+
+bool TranspositionTable::mapShared(const std::string &name, size_t entries) {
+    // N.B: portable segment names are a single '/' followed by the name
+    const std::string path = name[0] == '/' ? name : "/" + name;
+
+    bool created = true;
+    int fd = shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        created = false;
+        fd = shm_open(path.c_str(), O_RDWR, 0);
+    }
+    if (fd < 0) {
+        std::cerr << "Failed to open shared hash: " << path << "\n";
+        return false;
+    }
+
+    // a new segment is zero filled, which is an empty table at generation 0
+    size_t bytes = sizeof(SharedHeader) + entries * sizeof(TTSlot);
+    if (created && ftruncate(fd, bytes) != 0) {
+        std::cerr << "Failed to size shared hash: " << path << "\n";
+        shm_unlink(path.c_str());
+        close(fd);
+        return false;
+    } else if (!created) {
+        // N.B: the creator sizes the segment just after creating it, so it can briefly be empty
+        const auto deadline = std::chrono::steady_clock::now() + SHARED_SIZE_TIMEOUT;
+        struct stat st;
+        bytes = 0;
+        while (fstat(fd, &st) == 0 && (bytes = st.st_size) == 0 &&
+               std::chrono::steady_clock::now() < deadline) {
+            usleep(1000);
+        }
+
+        entries =
+            bytes > sizeof(SharedHeader) ? (bytes - sizeof(SharedHeader)) / sizeof(TTSlot) : 0;
+        if (entries == 0 || bytes != sizeof(SharedHeader) + entries * sizeof(TTSlot) ||
+            (entries & (entries - 1)) != 0) {
+            std::cerr << "Not a shared hash: " << path << "\n";
+            close(fd);
+            return false;
+        }
+    }
+
+    void *mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Failed to map shared hash: " << path << "\n";
+        return false;
+    }
+
+    unmapShared();
+    privateTable = std::vector<TTSlot>();
+    shmBase = mapped;
+    generation = &static_cast<SharedHeader *>(mapped)->generation;
+    table = reinterpret_cast<TTSlot *>(static_cast<char *>(mapped) + sizeof(SharedHeader));
+    indexMask = entries - 1;
+    shmName = name;
+    return true;
+}
+
+void TranspositionTable::unmapShared() {
+    if (!shmName.empty()) {
+        // a private table carries on from the shared generation
+        privateGeneration.store(generation->load(std::memory_order_relaxed));
+        generation = &privateGeneration;
+
+        munmap(shmBase, sizeof(SharedHeader) + size() * sizeof(TTSlot));
+        shmBase = nullptr;
+        table = nullptr;
+        shmName.clear();
+    }
+}
+
+bool TranspositionTable::save(const std::string &path) const {
+    const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to open hash file: " << path << "\n";
+        return false;
+    }
+
+    FileHeader header {};
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FILE_VERSION;
+    header.entrySize = sizeof(TTSlot);
+    header.numEntries = size();
+    header.keyCheck = getKeyCheck();
+    header.generation = generation->load(std::memory_order_relaxed);
+
+    // the whole table goes out in one sequential write
+    const bool ok = writeAll(fd, &header, sizeof(header)) &&
+                    writeAll(fd, table, size() * sizeof(TTSlot));
+    if (!ok) {
+        std::cerr << "Failed to write hash file: " << path << "\n";
+    }
+
+    // N.B: a failed close can still lose the data
+    return close(fd) == 0 && ok;
+}
+
+bool TranspositionTable::load(const std::string &path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open hash file: " << path << "\n";
+        return false;
+    }
+
+    // N.B: numEntries is checked against the largest table first, so the size can't overflow
+    static constexpr uint64_t MAX_ENTRIES = (MAX_SIZE_MB << 20) / sizeof(TTSlot);
+
+    FileHeader header;
+    struct stat st;
+    const bool valid =
+        readAll(fd, &header, sizeof(header)) &&
+        std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0 &&
+        header.version == FILE_VERSION && header.entrySize == sizeof(TTSlot) &&
+        header.keyCheck == getKeyCheck() && header.numEntries > 0 &&
+        header.numEntries <= MAX_ENTRIES && (header.numEntries & (header.numEntries - 1)) == 0 &&
+        fstat(fd, &st) == 0 &&
+        uint64_t(st.st_size) == sizeof(header) + header.numEntries * sizeof(TTSlot) &&
+        (!isShared() || header.numEntries == size());
+    if (!valid) {
+        std::cerr << "Not a compatible hash file: " << path << "\n";
+        close(fd);
+        return false;
+    }
+
+    // read straight into the table, so loading a large one doesn't need twice its memory
+    if (!isShared()) {
+        allocatePrivate(header.numEntries);
+    }
+
+    const bool ok = readAll(fd, table, size() * sizeof(TTSlot));
+    close(fd);
+    if (!ok) {
+        std::cerr << "Failed to read hash file: " << path << "\n";
+        clear();
+        return false;
+    }
+
+    generation->store(header.generation, std::memory_order_relaxed);
+    return true;
+}
+
+int TranspositionTable::hashfull() const {
+    const size_t sample = std::min<size_t>(1000, size());
+    const uint8_t currentGeneration = generation->load(std::memory_order_relaxed);
+
+    size_t used = 0;
+    for (size_t i = 0; i < sample; i++) {
+        const uint64_t data = table[i].data;
+        used += unpackDepth(data) >= 0 && unpackGeneration(data) == currentGeneration;
+    }
+
+    return used * 1000 / sample;
 }
 
 void TranspositionTable::clear() {
-    std::fill(table.begin(), table.end(), TTEntry {});
+    std::fill(table, table + size(), TTSlot {});
 }
@@ -1,5 +1,11 @@
+#pragma once
+
 #include "src/core/types.h"
 
+#include <atomic>
+#include <string>
+#include <vector>
+
 enum TTFlag : int8_t {
     EXACT,       // PV-Nodes
     LOWERBOUND,  // Cut-Nodes
@@ -14,41 +20,144 @@ enum TTFlag : int8_t {
  * as well as a flag that corresponds to the type of node
  */
 struct TTEntry {
-    uint64_t key = 0;        // 8 bytes
-    int depth = -1;          // 4 bytes
-    Eval eval;               // 4 bytes
-    TTFlag flag = NO_ENTRY;  // 1 byte
-};  // 24 bytes total
+    uint64_t key = 0;
+    int depth = -1;
+    Eval eval;
+    TTFlag flag = NO_ENTRY;
+    uint8_t generation = 0;
+};
+
+/**
+ * A TTEntry as stored in the table, packed into one 64 bit data word
+ *
+ * The key is stored XORed with the data, so a slot that another process wrote to while it was being
+ * read doesn't match any key instead of passing a mix of two entries off as one. All zero is an
+ * empty slot, so fresh shared memory needs no setup
+ */
+struct TTSlot {
+    uint64_t check;
+    uint64_t data;
+};  // 16 bytes total
 
 /**
  * Simple hash table used to memoize position evaluations for fast
  * resolutions during search
  *
- * Uses a simple "always-replace" scheme to maintain size
+ * Entries are kept between searches so later moves of a game can reuse them. Each search starts a
+ * new generation, and an entry from the current generation is only replaced by one at least as
+ * deep, so stale entries from earlier searches are the first to go
+ *
+ * The table can also live in a named POSIX shared memory segment, so that several engine processes
+ * analysing the same game share what they've searched. Slots are read and written without locks,
+ * relying on the key check in TTSlot to throw out any that were torn by concurrent writes. The
+ * generation is kept in the segment too, so every process's entries age with the searches of all
+ * of them, instead of each process treating the others' entries as stale
  */
 class TranspositionTable {
    private:
-    // Want sizeof(table) <= 128kb
-    // (128 * 1024) bytes / 24 bytes = 5461.33333...
-    // Round down to 2^12 = 4096 for faster modulos
-    static constexpr size_t TT_SIZE = 1 << 12;
-    std::array<TTEntry, TT_SIZE> table;
+    // either privateTable's storage or the shared memory segment
+    TTSlot *table;
+
+    // N.B: always a power of two so indexing is a mask instead of a modulo
+    uint64_t indexMask;
+
+    std::vector<TTSlot> privateTable;
+
+    // name of the shared memory segment the table is mapped from, empty if it's private
+    std::string shmName;
+
+    // start of the shared memory segment, which holds the shared generation before the table
+    void *shmBase = nullptr;
+
+    // N.B: wraps around; only equality with an entry's generation matters
+    std::atomic<uint8_t> privateGeneration {0};
+
+    // either privateGeneration or the one in the shared memory segment
+    std::atomic<uint8_t> *generation;
 
     constexpr uint64_t getIndex(uint64_t prehash) const {
-        // x mod 2^12 = x & (2^12 - 1)
-        return prehash & (TT_SIZE - 1);
+        return prehash & indexMask;
+    }
+
+    size_t size() const {
+        return indexMask + 1;
     }
 
+    // replaces the table with a cleared private one
+    void allocatePrivate(size_t entries);
+
+    // maps the table from a shared memory segment, creating it with the given number of entries
+    // if it doesn't exist yet. Returns false and prints why if it fails, leaving the table as it was
+    bool mapShared(const std::string &name, size_t entries);
+
+    void unmapShared();
+
    public:
+    // 2^12 entries, 64kb, small enough for one table per datagen thread
+    static constexpr size_t DEFAULT_ENTRIES = 1 << 12;
+
+    // sizes for the UCI "Hash" option, which also sets bench's default
+    static constexpr size_t DEFAULT_SIZE_MB = 16;
+    static constexpr size_t MAX_SIZE_MB = 4096;
+
     TranspositionTable();
 
+    ~TranspositionTable();
+
+    // N.B: the table may point into privateTable, so copies would share it
+    TranspositionTable(const TranspositionTable &) = delete;
+    TranspositionTable &operator=(const TranspositionTable &) = delete;
+
     // Looks up a position hash at some depth and returns its TTEntry if found AND that entry was
     // recorded at the same or better depth, std::nullopt otherwise.
     TTEntry lookup(uint64_t posHash, int ply, int depth) const;
 
-    // Creates and stores a TT entry. Note that this always succeeds, so it will overwrite the
-    // existing entry in the case of a collision or a duplicate.
+    // Creates and stores a TT entry, unless the slot holds a different position searched deeper
+    // during the current search
     void store(uint64_t posHash, Eval eval, int alpha, int beta, int ply, int depth);
 
+    // ages every entry by one search; for a shared table, in every process using it
+    void newSearch();
+
+    // Resizes to the largest power of two number of entries that fits in sizeMb megabytes, and
+    // clears the table. A shared table keeps the segment's size and contents if it already exists.
+    // Must not be called during search.
+    void resize(size_t sizeMb);
+
+    /**
+     * Moves the table into the named shared memory segment, or back to private memory if name is
+     * empty
+     *
+     * The first process to use a name creates the segment at this table's size; later ones attach
+     * to it at whatever size it was created with. The segment outlives the processes until it's
+     * removed, e.g. from /dev/shm. Returns false and prints why if it fails, leaving the table
+     * private. Must not be called during search
+     */
+    bool share(const std::string &name);
+
+    bool isShared() const;
+
+    /**
+     * Writes the table to a file, after a header recording its size, generation and key scheme
+     *
+     * Returns false and prints why if it fails. Must not be called during search
+     */
+    bool save(const std::string &path) const;
+
+    /**
+     * Replaces the table, including its size, with one written by save
+     *
+     * Tables saved with a different entry layout or different Zobrist keys are rejected, as are
+     * tables of a different size than a shared one, since other processes have it mapped, and
+     * tables larger than MAX_SIZE_MB. Returns false and prints why if it fails; the table is left
+     * as it was if the file is rejected, or cleared if reading it fails part way. Must not be
+     * called during search
+     */
+    bool load(const std::string &path);
+
+    // permille of entries from the current search, sampled from the first 1000, for UCI's hashfull
+    int hashfull() const;
+
+    // N.B: a shared table is cleared for every process using it
     void clear();
 };
@@ -0,0 +1,22 @@
+#include "MateSearchStopper.h"
+
+MateSearchStopper::MateSearchStopper(int mateLimit)
+    : mateLimit(mateLimit) {}
+
+void MateSearchStopper::setMateLimit(int mateLimit) {
+    this->mateLimit = mateLimit;
+}
+
+void MateSearchStopper::onIterationComplete(int depth, Eval score) {
+    // mate in n moves is scored MATE_SCORE - (2n - 1)
+    if (score >= MATE_BOUND && (MATE_SCORE - score + 1) / 2 <= mateLimit) {
+        overrideAndAbort();
+        return;
+    }
+
+    // N.B: search is full width, but quiescence search doesn't detect checkmate, so any mate in
+    // mateLimit moves is found once the mated side's last move has depth left too
+    if (depth >= 2 * mateLimit) {
+        overrideAndAbort();
+    }
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "src/ai/search/SearchStopper.h"
+
+// stops search once it finds a mate in at most a given number of moves, or proves there is none
+class MateSearchStopper : public SearchStopper {
+   private:
+    // in moves, not plies
+    int mateLimit;
+
+   public:
+    MateSearchStopper(int mateLimit);
+
+    void setMateLimit(int mateLimit);
+
+    void onIterationComplete(int depth, Eval score) override;
+};
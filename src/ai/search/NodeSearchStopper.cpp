@@ -0,0 +1,18 @@
+#include "NodeSearchStopper.h"
+
+NodeSearchStopper::NodeSearchStopper(uint64_t nodeLimit)
+    : nodeLimit(nodeLimit) {}
+
+void NodeSearchStopper::setNodeLimit(uint64_t nodeLimit) {
+    this->nodeLimit = nodeLimit;
+}
+
+void NodeSearchStopper::poll(uint64_t nodes) {
+    if (nodes >= nodeLimit) {
+        overrideAndAbort();
+    }
+}
+
+uint64_t NodeSearchStopper::getNodeLimit() const {
+    return nodeLimit;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "src/ai/search/SearchStopper.h"
+
+// stops search after a fixed number of nodes
+// N.B: nodes are counted by the Searcher being stopped, so a limit is exact and reproducible
+class NodeSearchStopper : public SearchStopper {
+   private:
+    uint64_t nodeLimit;
+
+   public:
+    NodeSearchStopper(uint64_t nodeLimit);
+
+    void setNodeLimit(uint64_t nodeLimit);
+
+    void poll(uint64_t nodes) override;
+
+    uint64_t getNodeLimit() const override;
+};
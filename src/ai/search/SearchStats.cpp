@@ -0,0 +1,60 @@
+#include "SearchStats.h"
+
+#include <algorithm>
+#include <iomanip>
+
+// as a percentage, or 0 if there's nothing to divide by
+static double percent(uint64_t part, uint64_t whole) {
+    return whole == 0 ? 0.0 : 100.0 * part / whole;
+}
+
+void SearchStats::clear() {
+    *this = SearchStats {};
+}
+
+SearchStats &SearchStats::operator+=(const SearchStats &other) {
+    qsearchNodes += other.qsearchNodes;
+    ttProbes += other.ttProbes;
+    ttHits += other.ttHits;
+    ttCutoffs += other.ttCutoffs;
+    failHighs += other.failHighs;
+    firstMoveFailHighs += other.firstMoveFailHighs;
+    failHighIndexSum += other.failHighIndexSum;
+
+    if (nodesByDepth.size() < other.nodesByDepth.size()) {
+        nodesByDepth.resize(other.nodesByDepth.size(), 0);
+    }
+    for (size_t i = 0; i < other.nodesByDepth.size(); i++) {
+        nodesByDepth[i] += other.nodesByDepth[i];
+    }
+
+    return *this;
+}
+
+void SearchStats::print(std::ostream &out, uint64_t nodes) const {
+    const uint64_t mainNodes = nodes - std::min(nodes, qsearchNodes);
+    const double avgIndex = failHighs == 0 ? 0.0 : double(failHighIndexSum) / failHighs;
+
+    out << std::fixed << std::setprecision(1);
+
+    out << "info string stats nodes " << nodes << " main " << mainNodes << " ("
+        << percent(mainNodes, nodes) << "%) qsearch " << qsearchNodes << " ("
+        << percent(qsearchNodes, nodes) << "%)\n";
+
+    out << "info string stats tt probes " << ttProbes << " hits " << ttHits << " ("
+        << percent(ttHits, ttProbes) << "%) cutoffs " << ttCutoffs << " ("
+        << percent(ttCutoffs, ttProbes) << "%)\n";
+
+    out << "info string stats failhighs " << failHighs << " first move "
+        << percent(firstMoveFailHighs, failHighs) << "% avg index " << std::setprecision(2)
+        << avgIndex << '\n';
+
+    // nodes spent on depth d over nodes spent on depth d - 1
+    out << "info string stats ebf";
+    for (size_t i = 1; i < nodesByDepth.size(); i++) {
+        const uint64_t prev = nodesByDepth[i - 1] - (i > 1 ? nodesByDepth[i - 2] : 0);
+        const uint64_t cur = nodesByDepth[i] - nodesByDepth[i - 1];
+        out << " d" << i + 1 << ' ' << (prev == 0 ? 0.0 : double(cur) / prev);
+    }
+    out << std::defaultfloat << std::endl;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// N.B: counting is compiled in with -DSEARCH_STATS (meson configure -Dsearch_stats=true); updates
+// are guarded by `if constexpr`, so without it search compiles to the same code as if they weren't
+// there
+#ifdef SEARCH_STATS
+constexpr bool SEARCH_STATS_ENABLED = true;
+#else
+constexpr bool SEARCH_STATS_ENABLED = false;
+#endif
+
+// counters describing how well search is pruning, for tuning move ordering and the TT
+struct SearchStats {
+    uint64_t qsearchNodes = 0;
+
+    // a hit is an entry with the right key and enough depth to be used
+    uint64_t ttProbes = 0;
+    uint64_t ttHits = 0;
+    uint64_t ttCutoffs = 0;
+
+    // main search fail highs, and how far down the move list they happened
+    uint64_t failHighs = 0;
+    uint64_t firstMoveFailHighs = 0;
+    uint64_t failHighIndexSum = 0;
+
+    // total nodes when each depth completed, indexed by depth - 1
+    std::vector<uint64_t> nodesByDepth;
+
+    void clear();
+
+    // adds counters, and nodesByDepth depth by depth, so several searches can be reported together
+    SearchStats &operator+=(const SearchStats &other);
+
+    // prints "info string" lines, given the total nodes searched
+    void print(std::ostream &out, uint64_t nodes) const;
+};
@@ -1,13 +1,46 @@
 #pragma once
 
-// Base interface that tells Searcher when to stop running
+#include "src/core/types.h"
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+/**
+ * Base class that tells Searcher when to stop running
+ *
+ * Searcher checks isStopped after every move, so it is a single relaxed load of a flag. Stoppers
+ * with a limit of their own check it in poll, which Searcher only calls every few hundred nodes
+ */
 class SearchStopper {
+   protected:
+    std::atomic<bool> stopped{false};
+
    public:
+    static constexpr uint64_t NO_NODE_LIMIT = std::numeric_limits<uint64_t>::max();
+
     virtual ~SearchStopper() = default;
 
-    virtual void reset() = 0;
+    virtual void reset() {
+        stopped.store(false, std::memory_order_relaxed);
+    }
+
+    // stops the search if the stopper's limit has been reached after searching this many nodes
+    virtual void poll(uint64_t /* nodes */) {}
+
+    // called with the score of every depth that iterative deepening completes
+    virtual void onIterationComplete(int /* depth */, Eval /* score */) {}
+
+    // Searcher polls again exactly when this many nodes have been searched
+    virtual uint64_t getNodeLimit() const {
+        return NO_NODE_LIMIT;
+    }
 
-    virtual void overrideAndAbort() = 0;
+    void overrideAndAbort() {
+        stopped.store(true, std::memory_order_relaxed);
+    }
 
-    virtual bool isStopped() = 0;
+    bool isStopped() const {
+        return stopped.load(std::memory_order_relaxed);
+    }
 };
@@ -0,0 +1,55 @@
+#include "SearchStopperGroup.h"
+
+#include <algorithm>
+#include <cassert>
+
+void SearchStopperGroup::update() {
+    for (const SearchStopper *stopper : stoppers) {
+        if (stopper->isStopped()) {
+            overrideAndAbort();
+            return;
+        }
+    }
+}
+
+void SearchStopperGroup::add(SearchStopper *stopper) {
+    assert(stopper != nullptr && stopper != this);
+    stoppers.push_back(stopper);
+}
+
+void SearchStopperGroup::clear() {
+    stoppers.clear();
+}
+
+void SearchStopperGroup::reset() {
+    for (SearchStopper *stopper : stoppers) {
+        stopper->reset();
+    }
+
+    SearchStopper::reset();
+}
+
+void SearchStopperGroup::poll(uint64_t nodes) {
+    for (SearchStopper *stopper : stoppers) {
+        stopper->poll(nodes);
+    }
+
+    update();
+}
+
+void SearchStopperGroup::onIterationComplete(int depth, Eval score) {
+    for (SearchStopper *stopper : stoppers) {
+        stopper->onIterationComplete(depth, score);
+    }
+
+    update();
+}
+
+uint64_t SearchStopperGroup::getNodeLimit() const {
+    uint64_t nodeLimit = NO_NODE_LIMIT;
+    for (const SearchStopper *stopper : stoppers) {
+        nodeLimit = std::min(nodeLimit, stopper->getNodeLimit());
+    }
+
+    return nodeLimit;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "src/ai/search/SearchStopper.h"
+
+#include <vector>
+
+/**
+ * Combines several stoppers, e.g. a time and a node limit, stopping as soon as any of them does
+ *
+ * An empty group only stops when overrideAndAbort is called. Members are reset and polled through
+ * the group, so they shouldn't also be given to a Searcher directly
+ */
+class SearchStopperGroup : public SearchStopper {
+   private:
+    std::vector<SearchStopper *> stoppers;
+
+    // stops the group if any member has stopped
+    void update();
+
+   public:
+    void add(SearchStopper *stopper);
+
+    void clear();
+
+    void reset() override;
+
+    void poll(uint64_t nodes) override;
+
+    void onIterationComplete(int depth, Eval score) override;
+
+    uint64_t getNodeLimit() const override;
+};
@@ -9,24 +9,25 @@ void SearchStopwatch::setTimeLimit(int timeLimitMs) {
     timeLimit = std::chrono::milliseconds(timeLimitMs);
 }
 
-void SearchStopwatch::reset() {
-    startTime = std::chrono::steady_clock::now();
-    stopped.store(false, std::memory_order_relaxed);
+void SearchStopwatch::setPaused(bool paused) {
+    if (!paused) {
+        startTime.store(std::chrono::steady_clock::now(), std::memory_order_relaxed);
+    }
+
+    this->paused.store(paused, std::memory_order_release);
 }
 
-void SearchStopwatch::overrideAndAbort() {
-    stopped.store(true, std::memory_order_relaxed);
+void SearchStopwatch::reset() {
+    startTime.store(std::chrono::steady_clock::now(), std::memory_order_relaxed);
+    SearchStopper::reset();
 }
 
-bool SearchStopwatch::isStopped() {
-    if (stopped.load(std::memory_order_relaxed)) {
-        return true;
+void SearchStopwatch::poll(uint64_t /* nodes */) {
+    if (paused.load(std::memory_order_acquire)) {
+        return;
     }
 
-    if (std::chrono::steady_clock::now() - startTime >= timeLimit) {
-        stopped.store(true, std::memory_order_relaxed);
-        return true;
+    if (std::chrono::steady_clock::now() - startTime.load(std::memory_order_relaxed) >= timeLimit) {
+        overrideAndAbort();
     }
-
-    return false;
 }
@@ -1,3 +1,5 @@
+#pragma once
+
 #include "src/ai/search/SearchStopper.h"
 
 #include <atomic>
@@ -6,19 +8,21 @@
 // stops search after a fixed amount of time
 class SearchStopwatch : public SearchStopper {
    private:
-    std::chrono::steady_clock::time_point startTime;
+    // N.B: atomic because pondering restarts the clock from the UCI thread during search
+    std::atomic<std::chrono::steady_clock::time_point> startTime;
     std::chrono::milliseconds timeLimit;
 
-    std::atomic<bool> stopped;
+    std::atomic<bool> paused{false};
 
    public:
     SearchStopwatch(int timeLimitMs);
 
     void setTimeLimit(int timeLimitMs);
 
-    void reset() override;
+    // the time limit can't be reached while paused; unpausing restarts the clock
+    void setPaused(bool paused);
 
-    void overrideAndAbort() override;
+    void reset() override;
 
-    bool isStopped() override;
+    void poll(uint64_t nodes) override;
 };
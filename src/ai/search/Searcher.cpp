@@ -1,13 +1,37 @@
 #include "Searcher.h"
 
+#include "src/core/AttackMap.h"
 #include "src/movegen/MoveGenerator.h"
 
+#include "src/core/Notation.h"
+#include "src/core/UciOutput.h"
+
+#include <algorithm>
 #include <chrono>
-#include <iostream>
+#include <sstream>
+
+// the stopper is polled once per this many nodes, or sooner if it has a node limit
+// N.B: small enough to stop within a few ms of a time limit at the engine's speed
+static constexpr uint64_t POLL_INTERVAL = 256;
+
+// root moves are reported with currmove once an iteration has been running this long
+static constexpr int CURRMOVE_DELAY_MS = 3000;
+
+// info lines of iterations that finish sooner than this are held back until it has passed, and
+// only the last iteration's are written; fast iterations would otherwise cost a write per line in
+// bullet games
+static constexpr int INFO_DELAY_MS = 250;
+
+// returned by quiescenceSearch for a position whose mover left its king attacked; outside the
+// range of real scores so the parent can tell it apart
+static constexpr Eval ILLEGAL_POSITION = INFINITY + 1;
 
 Searcher::Searcher(SearchStopper *searchStopper)
     : searchStopper(searchStopper) {
     assert(searchStopper != nullptr);
+
+    // N.B: room for a few lines with long PVs, so holding info lines back doesn't allocate
+    pendingInfo.reserve(4096);
 }
 
 void Searcher::setStopper(SearchStopper *searchStopper) {
@@ -15,6 +39,10 @@ void Searcher::setStopper(SearchStopper *searchStopper) {
     this->searchStopper = searchStopper;
 }
 
+void Searcher::setTimeManager(TimeManager *timeManager) {
+    this->timeManager = timeManager;
+}
+
 void Searcher::addToRepetitionTable(uint64_t posHash) {
     repetitionTable.push(posHash);
 }
@@ -27,22 +55,178 @@ void Searcher::abortSearch() {
     searchStopper->overrideAndAbort();
 }
 
+void Searcher::resetStopper() {
+    searchStopper->reset();
+}
+
+void Searcher::setPrintInfo(bool printInfo) {
+    this->printInfo = printInfo;
+}
+
+void Searcher::setSearchMoves(const std::vector<Move> &searchMoves) {
+    this->searchMoves = searchMoves;
+}
+
+void Searcher::setMultiPV(int multiPV) {
+    this->multiPV = std::max(1, multiPV);
+}
+
+void Searcher::setHashSize(size_t sizeMb) {
+    tt.resize(sizeMb);
+}
+
+void Searcher::clearHash() {
+    tt.clear();
+}
+
+bool Searcher::saveHash(const std::string &path) const {
+    return tt.save(path);
+}
+
+bool Searcher::loadHash(const std::string &path) {
+    return tt.load(path);
+}
+
+bool Searcher::shareHash(const std::string &name) {
+    return tt.share(name);
+}
+
+bool Searcher::isHashShared() const {
+    return tt.isShared();
+}
+
+Eval Searcher::getLastScore() const {
+    return lastScore;
+}
+
+Move Searcher::getPonderMove() const {
+    return ponderMove;
+}
+
+uint64_t Searcher::getNodesSearched() const {
+    return nodesSearched;
+}
+
+const SearchStats &Searcher::getStats() const {
+    return stats;
+}
+
+int64_t Searcher::elapsedMs() const {
+    const auto elapsed = std::chrono::steady_clock::now() - startTime;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+}
+
+void Searcher::writePendingInfo() {
+    UciOutput::write(pendingInfo);
+    pendingInfo.clear();
+}
+
+bool Searcher::shouldStop() {
+    if (!pendingInfo.empty() && elapsedMs() >= INFO_DELAY_MS) {
+        writePendingInfo();
+    }
+
+    // N.B: limits only apply once depth 1 completes, so there is always a move to play
+    if (completedDepth > 0) {
+        searchStopper->poll(nodesSearched);
+    }
+
+    // node limits are exact, so poll when one is reached even if that is sooner
+    const uint64_t nodeLimit = searchStopper->getNodeLimit();
+    nextPoll = nodesSearched + POLL_INTERVAL;
+    if (nodeLimit > nodesSearched && nodeLimit < nextPoll) {
+        nextPoll = nodeLimit;
+    }
+
+    return searchStopper->isStopped();
+}
+
+void Searcher::searchRoot(Position &pos, int depth, size_t pvIndex) {
+    Eval alpha = -INFINITY;
+
+    repetitionTable.push(pos.getHash());
+    nodesSearched++;
+
+    for (size_t i = pvIndex; i < rootMoves.size(); i++) {
+        RootMove &rootMove = rootMoves[i];
+
+        // N.B: only on long searches; GUIs use it to show progress, not to follow every move
+        if (printInfo && elapsedMs() >= CURRMOVE_DELAY_MS) {
+            UciOutput() << "info depth " << depth << " currmove "
+                        << Notation::moveToUci(rootMove.move) << " currmovenumber " << i + 1;
+        }
+
+        // N.B: root moves are all legal
+        Position::Metadata md = pos.makeMove(rootMove.move);
+        const Eval score = -negamax(pos, -INFINITY, -alpha, 1, depth - 1);
+        pos.unmakeMove(rootMove.move, md);
+
+        // exit if time is up; the iteration's results are discarded
+        if (searchStopper->isStopped()) {
+            repetitionTable.pop();
+            return;
+        }
+
+        if (score > alpha) {
+            alpha = score;
+            rootMove.score = score;
+
+            rootMove.pv.assign(1, rootMove.move);
+            const std::vector<Move> line = pvTable.getLine(1);
+            rootMove.pv.insert(rootMove.pv.end(), line.begin(), line.end());
+        } else {
+            rootMove.score = -INFINITY;
+        }
+    }
+
+    repetitionTable.pop();
+
+    // stable, so moves that failed low keep their order from the last iteration
+    std::stable_sort(rootMoves.begin() + pvIndex, rootMoves.end(),
+                     [](const RootMove &a, const RootMove &b) { return a.score > b.score; });
+}
+
 Eval Searcher::negamax(Position &pos, Eval alpha, Eval beta, int ply, int depth) {
-    // check for cancellation every 2048 nodes
-    if ((nodesSearched & 2047) == 0 && searchStopper->isStopped()) {
+    // check for cancellation every POLL_INTERVAL nodes
+    if (nodesSearched >= nextPoll && shouldStop()) {
         return 0;
     }
 
+    selDepth = std::max(selDepth, ply);
+
+    // N.B: nodes that return before finding a PV must not leave a stale one for their parent
+    pvTable.clearLength(ply);
+
     uint64_t h = pos.getHash();
 
     if (ply > 0) {
         // check for repetition
-        if (repetitionTable.contains(h)) {
+        if (repetitionTable.contains(h, pos.getMetadata().movesSinceCapture)) {
             return 0;
         }
 
+        // the side to move can force a repetition, so it can do no worse than a draw
+        if (alpha < 0 && repetitionTable.hasUpcomingRepetition(pos, ply)) {
+            alpha = 0;
+            if (alpha >= beta) {
+                return alpha;
+            }
+        }
+
         // probe TT
         TTEntry tte = tt.lookup(h, ply, depth);
+        if constexpr (SEARCH_STATS_ENABLED) {
+            stats.ttProbes++;
+            if (tte.flag != TTFlag::NO_ENTRY) {
+                stats.ttHits++;
+                if (tte.flag == TTFlag::EXACT ||
+                    (tte.flag == TTFlag::LOWERBOUND && tte.eval >= beta) ||
+                    (tte.flag == TTFlag::UPPERBOUND && tte.eval <= alpha)) {
+                    stats.ttCutoffs++;
+                }
+            }
+        }
+
         if (tte.flag == TTFlag::EXACT) {
             pvTable.clearLength(ply);
             return tte.eval;
@@ -102,6 +286,12 @@ Eval Searcher::negamax(Position &pos, Eval alpha, Eval beta, int ply, int depth)
 
             // node fails high
             if (score >= beta) {
+                if constexpr (SEARCH_STATS_ENABLED) {
+                    stats.failHighs++;
+                    stats.firstMoveFailHighs += legalMoveCount == 1;
+                    stats.failHighIndexSum += legalMoveCount;
+                }
+
                 tt.store(h, score, originalAlpha, beta, ply, depth);
                 repetitionTable.pop();
                 return beta;
@@ -136,8 +326,18 @@ Eval Searcher::negamax(Position &pos, Eval alpha, Eval beta, int ply, int depth)
 }
 
 Eval Searcher::quiescenceSearch(Position &pos, Eval alpha, Eval beta, int ply) {
+    // computed once per node and shared by the legality test and the evaluator
+    const AttackMap attackMap(pos);
+
+    // the parent searches captures without testing them; an illegal one is rejected here
+    if (attackMap.isIllegal(pos)) {
+        return ILLEGAL_POSITION;
+    }
+
+    selDepth = std::max(selDepth, ply);
+
     // initialize with static eval
-    Eval staticEval = evaluator.run(pos);
+    Eval staticEval = evaluator.run(pos, attackMap);
     if (staticEval >= beta) {
         return staticEval;
     }
@@ -145,13 +345,16 @@ Eval Searcher::quiescenceSearch(Position &pos, Eval alpha, Eval beta, int ply) {
         alpha = staticEval;
     }
 
-    // check for cancellation every 2048 nodes
-    if ((nodesSearched & 2047) == 0 && searchStopper->isStopped()) {
+    // check for cancellation every POLL_INTERVAL nodes
+    if (nodesSearched >= nextPoll && shouldStop()) {
         return 0;
     }
 
     // increment node search count
     nodesSearched++;
+    if constexpr (SEARCH_STATS_ENABLED) {
+        stats.qsearchNodes++;
+    }
 
     // generate pseudolegal moves and filter later
     MoveList moves;
@@ -161,13 +364,13 @@ Eval Searcher::quiescenceSearch(Position &pos, Eval alpha, Eval beta, int ply) {
     for (const Move &move : moves) {
         Position::Metadata md = pos.makeMove(move);
 
-        // examine captures only
-        if (!pos.isLegal() || md.capturedPiece == NO_PIECE) {
+        // examine captures only; legality is checked by the child's attack map
+        if (md.capturedPiece == NO_PIECE) {
             pos.unmakeMove(move, md);
             continue;
         }
 
-        const Eval score = -quiescenceSearch(pos, -beta, -alpha, ply + 1);
+        const Eval childScore = quiescenceSearch(pos, -beta, -alpha, ply + 1);
 
         pos.unmakeMove(move, md);
 
@@ -176,6 +379,12 @@ Eval Searcher::quiescenceSearch(Position &pos, Eval alpha, Eval beta, int ply) {
             return 0;
         }
 
+        if (childScore == ILLEGAL_POSITION) {
+            continue;
+        }
+
+        const Eval score = -childScore;
+
         // found a better move
         if (score > alpha) {
             alpha = score;
@@ -194,60 +403,143 @@ Eval Searcher::quiescenceSearch(Position &pos, Eval alpha, Eval beta, int ply) {
 // We make pos a copy to prevent the worker thread from leaving the
 // global pos reference in an invalid state
 Move Searcher::run(Position pos, int maxDepth) {
-    searchStopper->reset();
-
     // N.B: Need to clear helper DSs here (killer moves, PV table, etc)
     nodesSearched = 0;
+    nextPoll = 0;
+    completedDepth = 0;
+    lastScore = 0;
+    ponderMove = Move::none();
     pvTable.clear();
+    stats.clear();
+    tt.newSearch();
+    pendingInfo.clear();
 
     Move bestFullySearchedMove = Move::none();
 
-    // for reporting NPS
-    auto start = std::chrono::steady_clock::now();
+    // root moves start in move ordering's order; every iteration then sorts them by score
+    MoveList moves;
+    MoveGenerator::generateLegal(moves, pos);
+    moveSorter.run(pos, moves);
+
+    rootMoves.clear();
+    for (const Move &move : moves) {
+        if (searchMoves.empty() ||
+            std::find(searchMoves.begin(), searchMoves.end(), move) != searchMoves.end()) {
+            rootMoves.push_back({move, -INFINITY, {}});
+        }
+    }
+
+    // N.B: can't be more lines than moves
+    const size_t numLines = std::min<size_t>(multiPV, rootMoves.size());
+
+    startTime = std::chrono::steady_clock::now();
 
     // iterative deepeninuug
     for (int depth = 1; depth <= maxDepth; depth++) {
-        Eval score = negamax(pos, -INFINITY, INFINITY, 0, depth);
-        auto end = std::chrono::steady_clock::now();
+        // stoppers can also stop between iterations, e.g. once a mate is found
+        if (searchStopper->isStopped()) {
+            break;
+        }
+
+        // N.B: the soft limit only applies between iterations; the stopper enforces the hard one
+        if (depth > 1 && timeManager != nullptr &&
+            timeManager->shouldStopIterating(bestFullySearchedMove, lastScore)) {
+            break;
+        }
+
+        // checkmate or stalemate; there is nothing to search
+        if (rootMoves.empty()) {
+            break;
+        }
+
+        selDepth = 0;
+
+        for (size_t pvIndex = 0; pvIndex < numLines && !searchStopper->isStopped(); pvIndex++) {
+            searchRoot(pos, depth, pvIndex);
+        }
 
         // exit early if search was cancelled
         if (searchStopper->isStopped()) {
             break;
         } else {
-            bestFullySearchedMove = pvTable.getBestMove();
+            const RootMove &best = rootMoves[0];
+            bestFullySearchedMove = best.move;
+            ponderMove = best.pv.size() > 1 ? best.pv[1] : Move::none();
+            completedDepth = depth;
+            lastScore = best.score;
+
+            if constexpr (SEARCH_STATS_ENABLED) {
+                stats.nodesByDepth.push_back(nodesSearched);
+            }
+
+            searchStopper->onIterationComplete(depth, lastScore);
+            searchStopper->poll(nodesSearched);
+        }
+
+        if (!printInfo) {
+            continue;
         }
 
-        int duration_ms =
-            std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        const int64_t timeMs = elapsedMs();
+        const uint64_t nps = nodesSearched * 1000 / std::max<int64_t>(timeMs, 1);
+        const int hashfull = tt.hashfull();
 
         // -------- UCI -------- //
 
-        // print current depth
-        std::cout << "info depth " << depth << " ";
+        pendingInfo.clear();
+        for (size_t i = 0; i < numLines; i++) {
+            const RootMove &line = rootMoves[i];
+            UciOutput out(pendingInfo);
 
-        // print number of nodes searched so far
-        std::cout << "nodes " << nodesSearched << " ";
+            out << "info depth " << depth << " seldepth " << selDepth << ' ';
 
-        // print evaluation or mate in x
-        if (abs(score) >= MATE_BOUND) {
-            int mateIn = (MATE_SCORE - abs(score) + 1) / 2;
-            if (score > 0) {
-                std::cout << "score mate " << mateIn << " ";
+            // only numbered when there's more than one line, as before MultiPV
+            if (numLines > 1) {
+                out << "multipv " << i + 1 << ' ';
+            }
+
+            // print evaluation or mate in x
+            const Eval score = line.score;
+            if (abs(score) >= MATE_BOUND) {
+                int mateIn = (MATE_SCORE - abs(score) + 1) / 2;
+                out << "score mate " << (score > 0 ? mateIn : -mateIn) << ' ';
             } else {
-                std::cout << "score mate -" << mateIn << " ";
+                out << "score cp " << score << ' ';
             }
-        } else {
-            std::cout << "score cp " << score << " ";
+
+            out << "nodes " << nodesSearched << " nps " << nps << " hashfull " << hashfull
+                << " time " << timeMs << ' ';
+
+            // print PV line
+            out << "pv";
+            for (const Move &move : line.pv) {
+                out << ' ' << Notation::moveToUci(move);
+            }
+        }
+
+        if (timeMs >= INFO_DELAY_MS) {
+            writePendingInfo();
         }
+    }
 
-        // print PV line
-        std::cout << "pv " << pvTable.getBestLine() << std::endl;
+    // the last iteration is always reported, even if it finished quickly
+    if (!pendingInfo.empty()) {
+        writePendingInfo();
+    }
 
-        // print nodes per second if search takes longer than a second
-        if (duration_ms > 1000) {
-            std::cout << "info nps " << 1000 * nodesSearched / duration_ms << std::endl;
+    if constexpr (SEARCH_STATS_ENABLED) {
+        if (printInfo) {
+            std::ostringstream out;
+            stats.print(out, nodesSearched);
+            UciOutput::write(out.str());
         }
     }
 
+    // a search stopped before finishing depth 1, e.g. by a "stop" sent right after "go", still
+    // needs to play a legal move
+    if (bestFullySearchedMove == Move::none() && !rootMoves.empty()) {
+        return rootMoves[0].move;
+    }
+
     return bestFullySearchedMove;
 }
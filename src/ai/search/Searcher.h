@@ -5,12 +5,30 @@
 #include "src/ai/PVTable.h"
 #include "src/ai/RepetitionTable.h"
 #include "src/ai/TranspositionTable.h"
+#include "src/ai/search/SearchStats.h"
 #include "src/ai/search/SearchStopper.h"
+#include "src/ai/search/TimeManager.h"
 #include "src/core/Move.h"
 #include "src/core/Position.h"
 
+#include <chrono>
+#include <string>
+#include <vector>
+
 class Searcher {
    private:
+    // a legal move at the root and what the current iteration has found for it
+    struct RootMove {
+        Move move;
+
+        // exact for a move that was the best so far when it was searched; moves that failed low
+        // only have an upper bound, so they're given -INFINITY
+        Eval score = -INFINITY;
+
+        // starts with move
+        std::vector<Move> pv;
+    };
+
     TranspositionTable tt;
 
     MoveSorter moveSorter;
@@ -21,10 +39,63 @@ class Searcher {
 
     SearchStopper *searchStopper;
 
+    // decides when to stop iterative deepening; nullptr searches until stopped or maxDepth
+    TimeManager *timeManager = nullptr;
+
     RepetitionTable repetitionTable;
 
+    // sorted best first, so the first multiPV moves are the reported lines
+    std::vector<RootMove> rootMoves;
+
+    // restricts the root to these moves; empty searches every legal move
+    std::vector<Move> searchMoves;
+
+    // number of best lines to search and report
+    int multiPV = 1;
+
     uint64_t nodesSearched;
 
+    // the stopper is polled when nodesSearched reaches this
+    uint64_t nextPoll = 0;
+
+    // score of the last fully searched depth, from the side to move's perspective
+    Eval lastScore = 0;
+
+    // expected reply to the best move of the last fully searched depth
+    Move ponderMove = Move::none();
+
+    int completedDepth = 0;
+
+    // deepest ply reached in the current iteration, including quiescence search
+    int selDepth = 0;
+
+    std::chrono::steady_clock::time_point startTime;
+
+    // whether to print UCI info lines while searching
+    bool printInfo = true;
+
+    // info lines of the last iteration, if they haven't been written yet
+    std::string pendingInfo;
+
+    // only counted when SEARCH_STATS_ENABLED
+    SearchStats stats;
+
+    // polls the stopper, schedules the next poll and writes held back info lines once due
+    // N.B: may read the clock, so it is only called every few hundred nodes
+    bool shouldStop();
+
+    int64_t elapsedMs() const;
+
+    void writePendingInfo();
+
+    /**
+     * Finds the best of rootMoves[pvIndex..] and sorts it to pvIndex
+     *
+     * N.B: each line is one search of the moves not already reported, so MultiPV costs one extra
+     * root search per line
+     */
+    void searchRoot(Position &pos, int depth, size_t pvIndex);
+
     Eval negamax(Position &pos, Eval alpha, Eval beta, int ply, int depth);
 
     Eval quiescenceSearch(Position &pos, Eval alpha, Eval beta, int ply);
@@ -34,11 +105,48 @@ class Searcher {
 
     void setStopper(SearchStopper *searchStopper);
 
+    void setTimeManager(TimeManager *timeManager);
+
     void addToRepetitionTable(uint64_t posHash);
 
     void clearRepetitionTable();
 
     void abortSearch();
 
+    // readies the stopper for a new search; see run
+    void resetStopper();
+
+    void setPrintInfo(bool printInfo);
+
+    void setSearchMoves(const std::vector<Move> &searchMoves);
+
+    void setMultiPV(int multiPV);
+
+    // resizes the transposition table, clearing it
+    void setHashSize(size_t sizeMb);
+
+    void clearHash();
+
+    // see TranspositionTable::save and load
+    bool saveHash(const std::string &path) const;
+
+    bool loadHash(const std::string &path);
+
+    // see TranspositionTable::share
+    bool shareHash(const std::string &name);
+
+    bool isHashShared() const;
+
+    Eval getLastScore() const;
+
+    Move getPonderMove() const;
+
+    uint64_t getNodesSearched() const;
+
+    // statistics of the last search; empty unless SEARCH_STATS_ENABLED
+    const SearchStats &getStats() const;
+
+    // N.B: the stopper isn't reset here, or a stop sent while the search thread was starting up
+    // would be lost; whoever starts the search resets it first
     Move run(Position pos, int maxDepth);
 };
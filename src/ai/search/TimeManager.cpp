@@ -0,0 +1,81 @@
+#include "TimeManager.h"
+
+#include <algorithm>
+
+void TimeManager::setMoveOverhead(int moveOverheadMs) {
+    moveOverhead = std::max(0, moveOverheadMs);
+}
+
+void TimeManager::init(const Limits &limits) {
+    startTime.store(std::chrono::steady_clock::now(), std::memory_order_relaxed);
+    paused.store(false, std::memory_order_relaxed);
+    lastBestMove = Move::none();
+    bestMoveStability = 0;
+    lastScore = 0;
+
+    if (limits.moveTime >= 0) {
+        fixedTime = true;
+        softLimit = hardLimit = std::max(1, limits.moveTime - moveOverhead);
+        return;
+    }
+
+    fixedTime = false;
+
+    const int movesToGo = limits.movesToGo > 0 ? std::min(limits.movesToGo, MAX_MOVES_TO_GO)
+                                               : SUDDEN_DEATH_MOVES;
+
+    // time available until the next time control, keeping back the overhead of every move
+    const int timeLeft = std::max(
+        1, limits.time + limits.increment * (movesToGo - 1) - moveOverhead * movesToGo);
+
+    const int maxTime = std::max(1, int(limits.time * MAX_CLOCK_SHARE) - moveOverhead);
+
+    hardLimit = std::min(timeLeft / movesToGo * HARD_LIMIT_RATIO, maxTime);
+    softLimit = std::max(1, std::min(timeLeft / movesToGo, hardLimit));
+}
+
+int TimeManager::getHardLimit() const {
+    return hardLimit;
+}
+
+void TimeManager::setPaused(bool paused) {
+    if (!paused) {
+        startTime.store(std::chrono::steady_clock::now(), std::memory_order_relaxed);
+    }
+
+    this->paused.store(paused, std::memory_order_release);
+}
+
+bool TimeManager::shouldStopIterating(const Move &bestMove, Eval score) {
+    if (fixedTime) {
+        return false;
+    }
+
+    if (bestMove == lastBestMove) {
+        bestMoveStability = std::min(bestMoveStability + 1, MAX_STABILITY);
+    } else {
+        bestMoveStability = 0;
+    }
+
+    // 1.3x while the best move is changing, down to 0.7x once it has settled
+    double scale = 1.3 - 0.1 * bestMoveStability;
+
+    // a falling score means the position is worse than it looked, so look deeper; up to 1.5x
+    const int scoreDrop = lastBestMove == Move::none() ? 0 : lastScore - score;
+    if (scoreDrop > 20) {
+        scale *= 1.0 + std::min(scoreDrop, 100) / 200.0;
+    }
+
+    lastBestMove = bestMove;
+    lastScore = score;
+
+    if (paused.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::steady_clock::now() -
+                             startTime.load(std::memory_order_relaxed))
+                             .count();
+    return elapsed >= softLimit * scale;
+}
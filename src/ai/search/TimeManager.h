@@ -0,0 +1,83 @@
+#pragma once
+
+#include "src/core/Move.h"
+#include "src/core/types.h"
+
+#include <atomic>
+#include <chrono>
+
+/**
+ * Decides how long to think from the UCI clock parameters
+ *
+ * The hard limit caps the whole search and is enforced inside it by a SearchStopwatch. The soft
+ * limit is only checked between iterations, and it grows while the best move keeps changing or the
+ * score is dropping, and shrinks once the best move has settled
+ */
+class TimeManager {
+   public:
+    // units are ms; negative times mean the parameter wasn't given
+    struct Limits {
+        int time = -1;
+        int increment = 0;
+        int movesToGo = 0;
+        int moveTime = -1;
+    };
+
+    static constexpr int DEFAULT_MOVE_OVERHEAD = 10;
+
+   private:
+    // moves the remaining time is spread over when the time control has no movestogo
+    static constexpr int SUDDEN_DEATH_MOVES = 30;
+
+    static constexpr int MAX_MOVES_TO_GO = 50;
+
+    // the hard limit allows overrunning the soft limit by this much at most
+    static constexpr int HARD_LIMIT_RATIO = 5;
+
+    // never plan to use more than this share of the clock on one move
+    static constexpr double MAX_CLOCK_SHARE = 0.8;
+
+    // iterations with the same best move after which the soft limit stops shrinking
+    static constexpr int MAX_STABILITY = 6;
+
+    // N.B: atomic because pondering restarts the clock from the UCI thread during search
+    std::atomic<std::chrono::steady_clock::time_point> startTime;
+
+    // while pondering the clock isn't running, so iterative deepening never stops
+    std::atomic<bool> paused{false};
+
+    int softLimit = 0;
+
+    int hardLimit = 0;
+
+    // movetime is spent in full, so the soft limit doesn't apply
+    bool fixedTime = false;
+
+    // time lost to communication and the GUI on every move
+    int moveOverhead = DEFAULT_MOVE_OVERHEAD;
+
+    Move lastBestMove = Move::none();
+
+    // number of consecutive iterations that returned lastBestMove
+    int bestMoveStability = 0;
+
+    Eval lastScore = 0;
+
+   public:
+    void setMoveOverhead(int moveOverheadMs);
+
+    // starts the clock and computes the limits for a new search
+    void init(const Limits &limits);
+
+    int getHardLimit() const;
+
+    // unpausing restarts the clock with the limits from init
+    void setPaused(bool paused);
+
+    /**
+     * Called after each completed iteration of iterative deepening
+     *
+     * @return true if there isn't enough time left to make another iteration worth starting
+     */
+    bool shouldStopIterating(const Move &bestMove, Eval score);
+};
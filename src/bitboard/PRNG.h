@@ -1,25 +1,33 @@
-#include <limits>
+#pragma once
+
 #include <stdint.h>
 
-// linear congruential generator based on https://rosettacode.org/wiki/Linear_congruential_generator
+// xorshift64* generator (https://vigna.di.unimi.it/ftp/papers/xorshift.pdf)
 class PRNG {
    private:
-    int _a, _c;
-    uint32_t _seed;
+    uint64_t _state;
+
+    // N.B: fixed so that every build on every machine draws the same sequence
+    static constexpr uint64_t DEFAULT_SEED = 0x9E3779B97F4A7C15ull;
 
-    static constexpr uint32_t generateSeed() {
-        const char *timeStr = __TIME__;
-        return static_cast<uint32_t>(timeStr[0] * 3600 + timeStr[1] * 360 + timeStr[3] * 60 +
-                                     timeStr[4] * 10 + timeStr[6] + timeStr[7]);
+    // splitmix64 spreads similar seeds apart; the state must never be 0
+    static constexpr uint64_t mixSeed(uint64_t seed) {
+        seed += 0x9E3779B97F4A7C15ull;
+        seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ull;
+        seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBull;
+        seed ^= seed >> 31;
+        return seed != 0 ? seed : DEFAULT_SEED;
     }
 
    public:
-    // Microsoft LCG formula
-    constexpr PRNG(uint32_t seed = generateSeed())
-        : _a(214013), _c(2531011), _seed(seed) {}
+    constexpr PRNG(uint64_t seed = DEFAULT_SEED)
+        : _state(mixSeed(seed)) {}
 
-    // returns the next pseudo random number in the sequence
+    // returns the next pseudo random number in the sequence; all 64 bits are usable
     constexpr uint64_t next() {
-        return _seed = (_a * _seed + _c) & std::numeric_limits<uint64_t>::max();
+        _state ^= _state >> 12;
+        _state ^= _state << 25;
+        _state ^= _state >> 27;
+        return _state * 0x2545F4914F6CDD1Dull;
     }
 };
@@ -0,0 +1,364 @@
+#include "BookBuilder.h"
+
+#include "src/ai/PolyglotBook.h"
+#include "src/bitboard/bit_tools.h"
+#include "src/bookbuild/PgnReader.h"
+#include "src/core/Notation.h"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <queue>
+#include <thread>
+
+using BookRecord = BookBuilder::BookRecord;
+
+static bool operator<(const BookRecord &a, const BookRecord &b) {
+    return a.key != b.key ? a.key < b.key : a.move < b.move;
+}
+
+/**
+ * Open addressing hash map from (key, move) to counts with a fixed capacity. Once it is 3/4 full
+ * its records are sorted and spilled as a run, and it starts over empty
+ */
+class BookAccumulator {
+   private:
+    // N.B: games == 0 marks an empty slot
+    std::vector<BookRecord> slots;
+
+    size_t size = 0;
+
+    BookBuilder &builder;
+
+    size_t getIndex(uint64_t key, uint16_t move) const {
+        // keys are already uniformly distributed
+        return (key ^ (move * 0x9E3779B97F4A7C15ull)) & (slots.size() - 1);
+    }
+
+   public:
+    BookAccumulator(size_t capacity, BookBuilder &builder)
+        : slots(capacity), builder(builder) {}
+
+    void add(uint64_t key, uint16_t move, uint32_t score) {
+        size_t i = getIndex(key, move);
+        while (slots[i].games != 0 && (slots[i].key != key || slots[i].move != move)) {
+            i = (i + 1) & (slots.size() - 1);
+        }
+
+        if (slots[i].games == 0) {
+            slots[i] = {key, 0, 0, move};
+            size++;
+        }
+        slots[i].games++;
+        slots[i].score += score;
+
+        if (size >= slots.size() / 4 * 3) {
+            spill();
+        }
+    }
+
+    void spill() {
+        if (size == 0) {
+            return;
+        }
+
+        // compact and sort the records inside the table so a spill needs no memory of its own
+        const auto end = std::remove_if(
+            slots.begin(), slots.end(), [](const BookRecord &r) { return r.games == 0; });
+        std::sort(slots.begin(), end);
+        builder.writeRun(slots.data(), end - slots.begin());
+
+        std::fill(slots.begin(), slots.end(), BookRecord {});
+        size = 0;
+    }
+};
+
+// reads a sorted run file back in blocks
+class RunReader {
+   private:
+    std::ifstream file;
+
+    std::vector<BookRecord> buffer;
+
+    size_t index = 0, length = 0;
+
+   public:
+    explicit RunReader(const std::string &path)
+        : file(path, std::ios::binary), buffer(1 << 12) {}
+
+    bool next(BookRecord &record) {
+        if (index == length) {
+            file.read(reinterpret_cast<char *>(buffer.data()), buffer.size() * sizeof(BookRecord));
+            length = file.gcount() / sizeof(BookRecord);
+            index = 0;
+
+            if (length == 0) {
+                return false;
+            }
+        }
+
+        record = buffer[index++];
+        return true;
+    }
+};
+
+BookBuilder::BookBuilder(const Options &options, const std::string &outputPath)
+    : options(options), outputPath(outputPath) {}
+
+bool BookBuilder::addGame(const std::string &text, BookAccumulator &accumulator) const {
+    thread_local PgnGame game;
+    PgnReader::parse(text, game);
+
+    // score for the side that played each move, indexed by Color
+    std::array<uint32_t, 2> scores;
+    if (game.result == "1-0") {
+        scores = {2, 0};
+    } else if (game.result == "0-1") {
+        scores = {0, 2};
+    } else if (game.result == "1/2-1/2") {
+        scores = {1, 1};
+    } else {
+        return false;
+    }
+
+    // books are only probed from the standard starting position
+    if (!game.fen.empty() || game.moves.empty()) {
+        return false;
+    }
+
+    Position pos{std::string(STARTING_POSITION_FEN)};
+
+    const size_t numPlies = std::min<size_t>(game.moves.size(), options.maxPly);
+    for (size_t ply = 0; ply < numPlies; ply++) {
+        const Move move = Notation::sanToMove(pos, game.moves[ply]);
+
+        // keep what was read before an illegal or unreadable move
+        if (move == Move::none()) {
+            break;
+        }
+
+        accumulator.add(pos.getHash(), PolyglotBook::encodePgMove(move), scores[pos.getSideToMove()]);
+        pos.makeMove(move);
+    }
+
+    return true;
+}
+
+void BookBuilder::writeRun(const BookRecord *records, size_t count) {
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(runMutex);
+        path = outputPath + ".run" + std::to_string(runPaths.size());
+        runPaths.push_back(path);
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(records), count * sizeof(BookRecord));
+
+    if (!file) {
+        std::cerr << "Failed to write run file: " << path << std::endl;
+    }
+}
+
+size_t BookBuilder::mergeRuns() {
+    std::ofstream out(outputPath, std::ios::binary);
+    if (!out) {
+        std::cerr << "Failed to open output file: " << outputPath << std::endl;
+        return 0;
+    }
+
+    std::vector<RunReader> readers;
+    readers.reserve(runPaths.size());
+    for (const std::string &path : runPaths) {
+        readers.emplace_back(path);
+    }
+
+    // min heap of the next record from each run
+    using HeapItem = std::pair<BookRecord, size_t>;
+    auto greater = [](const HeapItem &a, const HeapItem &b) { return b.first < a.first; };
+    std::priority_queue<HeapItem, std::vector<HeapItem>, decltype(greater)> heap(greater);
+
+    for (size_t i = 0; i < readers.size(); i++) {
+        BookRecord r;
+        if (readers[i].next(r)) {
+            heap.push({r, i});
+        }
+    }
+
+    size_t entriesWritten = 0;
+
+    // every move of one position, merged across runs
+    std::vector<BookRecord> group;
+
+    auto writeGroup = [&]() {
+        group.erase(std::remove_if(group.begin(), group.end(),
+                                   [&](const BookRecord &r) {
+                                       return r.games < options.minGames || r.score == 0;
+                                   }),
+                    group.end());
+        if (group.empty()) {
+            return;
+        }
+
+        // weights are 16 bits, so scale down the rare positions that overflow them
+        uint32_t maxScore = 0;
+        for (const BookRecord &r : group) {
+            maxScore = std::max(maxScore, r.score);
+        }
+        const double scale = maxScore > UINT16_MAX ? double(UINT16_MAX) / maxScore : 1.0;
+
+        // most played first within a position, like other Polyglot tools
+        std::sort(group.begin(), group.end(),
+                  [](const BookRecord &a, const BookRecord &b) { return a.score > b.score; });
+
+        for (const BookRecord &r : group) {
+            const uint16_t weight = std::max<uint16_t>(1, uint16_t(r.score * scale));
+
+            // entries are big endian: key, move, weight, learn
+            const uint64_t key = swap64(r.key);
+            const uint16_t move = swap16(r.move), w = swap16(weight);
+            const uint32_t learn = 0;
+            out.write(reinterpret_cast<const char *>(&key), sizeof(key));
+            out.write(reinterpret_cast<const char *>(&move), sizeof(move));
+            out.write(reinterpret_cast<const char *>(&w), sizeof(w));
+            out.write(reinterpret_cast<const char *>(&learn), sizeof(learn));
+            entriesWritten++;
+        }
+    };
+
+    while (!heap.empty()) {
+        auto [r, i] = heap.top();
+        heap.pop();
+
+        BookRecord next;
+        if (readers[i].next(next)) {
+            heap.push({next, i});
+        }
+
+        if (!group.empty() && group.back().key != r.key) {
+            writeGroup();
+            group.clear();
+        }
+
+        // the same move may appear in several runs
+        if (!group.empty() && group.back().move == r.move) {
+            group.back().games += r.games;
+            group.back().score += r.score;
+        } else {
+            group.push_back(r);
+        }
+    }
+    writeGroup();
+
+    readers.clear();
+    for (const std::string &path : runPaths) {
+        std::remove(path.c_str());
+    }
+    runPaths.clear();
+
+    return entriesWritten;
+}
+
+size_t BookBuilder::run(const std::vector<std::string> &pgnPaths) {
+    const int numThreads = std::max(1, options.numThreads);
+
+    // largest power of two that fits each thread's share of the memory budget
+    const size_t budget = (options.memoryMB << 20) / numThreads / sizeof(BookRecord);
+    size_t capacity = 1 << 10;
+    while (capacity * 2 <= budget) {
+        capacity *= 2;
+    }
+
+    // games are handed to workers in batches through a bounded queue, so the reader can't run
+    // arbitrarily far ahead of parsing
+    static constexpr size_t BATCH_SIZE = 256;
+    const size_t maxBatches = 2 * numThreads;
+
+    std::deque<std::vector<std::string>> queue;
+    std::mutex queueMutex;
+    std::condition_variable notEmpty, notFull;
+    bool doneReading = false;
+
+    auto worker = [&]() {
+        BookAccumulator accumulator(capacity, *this);
+
+        while (true) {
+            std::vector<std::string> batch;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                notEmpty.wait(lock, [&] { return !queue.empty() || doneReading; });
+                if (queue.empty()) {
+                    break;
+                }
+                batch = std::move(queue.front());
+                queue.pop_front();
+            }
+            notFull.notify_one();
+
+            for (const std::string &text : batch) {
+                if (addGame(text, accumulator)) {
+                    gamesAdded++;
+                } else {
+                    gamesSkipped++;
+                }
+            }
+        }
+
+        accumulator.spill();
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back(worker);
+    }
+
+    for (const std::string &path : pgnPaths) {
+        PgnReader reader(path);
+        if (!reader.isOpen()) {
+            std::cerr << "Failed to open " << path << std::endl;
+            continue;
+        }
+
+        std::vector<std::string> batch;
+        std::string text;
+        while (reader.next(text)) {
+            batch.push_back(std::move(text));
+            if (batch.size() < BATCH_SIZE) {
+                continue;
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                notFull.wait(lock, [&] { return queue.size() < maxBatches; });
+                queue.push_back(std::move(batch));
+            }
+            notEmpty.notify_one();
+            batch.clear();
+        }
+
+        if (!batch.empty()) {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            queue.push_back(std::move(batch));
+        }
+        notEmpty.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        doneReading = true;
+    }
+    notEmpty.notify_all();
+
+    for (std::thread &th : threads) {
+        th.join();
+    }
+
+    std::cout << "Added " << gamesAdded << " games, skipped " << gamesSkipped << ", merging "
+              << runPaths.size() << " runs" << std::endl;
+
+    return mergeRuns();
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class BookAccumulator;
+
+/**
+ * Builds a Polyglot book from PGN files
+ *
+ * Every (position, move) pair from the first plies of each game is counted in a fixed size hash
+ * map per thread. Full maps are sorted and spilled to run files next to the output, and the runs
+ * are k-way merged into the final book, so memory use is bounded regardless of input size
+ */
+class BookBuilder {
+   public:
+    struct Options {
+        int numThreads = 1;
+
+        // only the first maxPly plies of each game are added
+        int maxPly = 24;
+
+        // moves played in fewer games than this are left out
+        uint32_t minGames = 1;
+
+        // combined size of every thread's hash map
+        size_t memoryMB = 512;
+    };
+
+    // a (position, move) pair and the games it was played in
+    struct BookRecord {
+        uint64_t key;
+        uint32_t games;
+
+        // 2 per win and 1 per draw for the side that played the move
+        uint32_t score;
+
+        uint16_t move;
+    };
+
+   private:
+    Options options;
+
+    std::string outputPath;
+
+    std::vector<std::string> runPaths;
+
+    std::mutex runMutex;
+
+    std::atomic<uint64_t> gamesAdded = 0;
+
+    std::atomic<uint64_t> gamesSkipped = 0;
+
+    // replays a game's text, counting its moves in records; returns false if it was skipped
+    bool addGame(const std::string &text, BookAccumulator &accumulator) const;
+
+    // writes count records, which must be sorted, to a new run file
+    void writeRun(const BookRecord *records, size_t count);
+
+    // merges every run into the output book; returns the number of entries written
+    size_t mergeRuns();
+
+    friend class BookAccumulator;
+
+   public:
+    BookBuilder(const Options &options, const std::string &outputPath);
+
+    /**
+     * Reads every game of every PGN file and writes the book
+     *
+     * @return the number of entries in the book
+     */
+    size_t run(const std::vector<std::string> &pgnPaths);
+};
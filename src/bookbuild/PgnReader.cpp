@@ -0,0 +1,140 @@
+#include "PgnReader.h"
+
+#include <cctype>
+
+PgnReader::PgnReader(const std::string &path)
+    : file(path) {}
+
+bool PgnReader::next(std::string &text) {
+    text = std::move(pending);
+    pending.clear();
+
+    bool inMovetext = false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        if (!line.empty() && line[0] == '[') {
+            // a tag after movetext starts the next game
+            if (inMovetext) {
+                pending = std::move(line) + '\n';
+                return true;
+            }
+        } else if (!line.empty()) {
+            inMovetext = true;
+        }
+
+        text += line;
+        text += '\n';
+    }
+
+    return !text.empty();
+}
+
+static bool isResult(const std::string &token) {
+    return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+}
+
+void PgnReader::parse(const std::string &text, PgnGame &game) {
+    game.result.clear();
+    game.fen.clear();
+    game.moves.clear();
+
+    const size_t n = text.size();
+    size_t i = 0;
+
+    while (i < n) {
+        const char c = text[i];
+
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            i++;
+        }
+
+        // ---- TAG PAIR ----
+        else if (c == '[') {
+            const size_t end = text.find('\n', i);
+            const std::string tag = text.substr(i, end == std::string::npos ? n - i : end - i);
+            i = end == std::string::npos ? n : end;
+
+            const size_t nameEnd = tag.find(' ');
+            const size_t valueBegin = tag.find('"'), valueEnd = tag.rfind('"');
+            if (nameEnd == std::string::npos || valueBegin == valueEnd) {
+                continue;
+            }
+
+            const std::string name = tag.substr(1, nameEnd - 1);
+            const std::string value = tag.substr(valueBegin + 1, valueEnd - valueBegin - 1);
+            if (name == "Result") {
+                game.result = value;
+            } else if (name == "FEN") {
+                game.fen = value;
+            }
+        }
+
+        // ---- COMMENTS ----
+        else if (c == '{') {
+            const size_t end = text.find('}', i);
+            i = end == std::string::npos ? n : end + 1;
+        } else if (c == ';') {
+            const size_t end = text.find('\n', i);
+            i = end == std::string::npos ? n : end + 1;
+        }
+
+        // ---- VARIATIONS ----
+        else if (c == '(') {
+            int depth = 0;
+            for (; i < n; i++) {
+                if (text[i] == '{') {
+                    const size_t end = text.find('}', i);
+                    i = end == std::string::npos ? n - 1 : end;
+                } else if (text[i] == '(') {
+                    depth++;
+                } else if (text[i] == ')' && --depth == 0) {
+                    break;
+                }
+            }
+            i++;
+        }
+
+        // ---- NAGS ----
+        else if (c == '$') {
+            for (i++; i < n && std::isdigit(static_cast<unsigned char>(text[i])); i++) {
+            }
+        }
+
+        // ---- MOVES, MOVE NUMBERS, AND TERMINATION ----
+        else {
+            const size_t begin = i;
+            while (i < n && !std::isspace(static_cast<unsigned char>(text[i])) && text[i] != '{' &&
+                   text[i] != '(' && text[i] != ')' && text[i] != ';') {
+                i++;
+            }
+            std::string token = text.substr(begin, i - begin);
+
+            // stray closing parenthesis
+            if (token.empty()) {
+                i++;
+                continue;
+            }
+
+            if (isResult(token)) {
+                return;
+            }
+
+            // move numbers may be attached to the move, e.g. "12.e4"
+            if (std::isdigit(static_cast<unsigned char>(token[0]))) {
+                const size_t dot = token.rfind('.');
+                if (dot != std::string::npos) {
+                    token.erase(0, dot + 1);
+                }
+            }
+
+            if (!token.empty()) {
+                game.moves.push_back(std::move(token));
+            }
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+// the parts of a PGN game that matter for building a book
+struct PgnGame {
+    // value of the Result tag, e.g. "1-0"
+    std::string result;
+
+    // value of the FEN tag; empty for games from the standard starting position
+    std::string fen;
+
+    // mainline moves in SAN
+    std::vector<std::string> moves;
+};
+
+/**
+ * Splits a PGN file into games, one at a time, so that files of any size can be streamed
+ */
+class PgnReader {
+   private:
+    std::ifstream file;
+
+    // first line of the next game, read while looking for the end of the previous one
+    std::string pending;
+
+   public:
+    explicit PgnReader(const std::string &path);
+
+    bool isOpen() const {
+        return file.is_open();
+    }
+
+    /**
+     * Reads the full text of the next game, tags and movetext
+     *
+     * @return false once the file is exhausted
+     */
+    bool next(std::string &text);
+
+    /**
+     * Parses the text of a single game. Comments, variations, NAGs, and move numbers are dropped,
+     * and parsing stops at the game termination marker
+     */
+    static void parse(const std::string &text, PgnGame &game);
+};
@@ -0,0 +1,47 @@
+#include "src/bookbuild/BookBuilder.h"
+
+#include <iostream>
+#include <string>
+#include <thread>
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: ./bookbuild <output.bin> <pgn files...> [-p plies] [-g min games]"
+                     " [-m memory MB] [-j threads]"
+                  << std::endl;
+        return 1;
+    }
+
+    BookBuilder::Options options;
+    options.numThreads = std::thread::hardware_concurrency();
+
+    const std::string output = argv[1];
+    std::vector<std::string> pgnPaths;
+
+    for (int i = 2; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "-p" && hasValue) {
+            options.maxPly = std::stoi(argv[++i]);
+        } else if (arg == "-g" && hasValue) {
+            options.minGames = std::stoul(argv[++i]);
+        } else if (arg == "-m" && hasValue) {
+            options.memoryMB = std::stoull(argv[++i]);
+        } else if (arg == "-j" && hasValue) {
+            options.numThreads = std::stoi(argv[++i]);
+        } else {
+            pgnPaths.push_back(arg);
+        }
+    }
+
+    std::cout << "Building " << output << " from the first " << options.maxPly << " plies of "
+              << pgnPaths.size() << " files on " << options.numThreads << " threads" << std::endl;
+
+    BookBuilder builder(options, output);
+    const size_t numEntries = builder.run(pgnPaths);
+
+    std::cout << "Wrote " << numEntries << " entries" << std::endl;
+
+    return 0;
+}
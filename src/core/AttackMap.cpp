@@ -0,0 +1,63 @@
+#include "AttackMap.h"
+
+#include "src/bitboard/Magic.h"
+
+template<PieceType Pt>
+inline Bitboard getPieceAttacks(Square sq, Bitboard occ) {
+    if constexpr (Pt == KNIGHT) {
+        return KNIGHT_MASKS[sq];
+    } else if constexpr (Pt == KING) {
+        return KING_MASKS[sq];
+    } else {
+        return Magic::getSlidingPieceAttacks<Pt>(sq, occ);
+    }
+}
+
+template<PieceType Pt>
+inline void
+addPieceAttacks(AttackMap &am, const Position &pos, Color c, Bitboard occ, Bitboard enemyKingZone) {
+    const Piece p = ptToPiece(Pt, c);
+    const Bitboard mobilityArea =
+        ~pos.getBoard().getOccupancy(c) & ~am.byPiece[ptToPiece(PAWN, otherColor(c))];
+
+    forEachSquare(pos.getPieceBB(p), [&](Square sq) {
+        const Bitboard attacks = getPieceAttacks<Pt>(sq, occ);
+
+        am.byPiece[p] |= attacks;
+        am.twice[c] |= am.byColor[c] & attacks;
+        am.byColor[c] |= attacks;
+        am.mobility[c][Pt] += getBitCount(attacks & mobilityArea);
+        am.kingZoneAttacks[c][Pt] += getBitCount(attacks & enemyKingZone);
+    });
+}
+
+void AttackMap::compute(const Position &pos) {
+    const Bitboard occ = pos.getBoard().getOccupancies();
+
+    byPiece.fill(0ull);
+
+    // pawns go first so that mobility can exclude squares attacked by enemy pawns
+    const Bitboard whitePawns = pos.getPieceBB(WP), blackPawns = pos.getPieceBB(BP);
+    const Bitboard wpEast = shift(whitePawns, NORTH_EAST), wpWest = shift(whitePawns, NORTH_WEST);
+    const Bitboard bpEast = shift(blackPawns, SOUTH_EAST), bpWest = shift(blackPawns, SOUTH_WEST);
+    byPiece[WP] = byColor[WHITE] = wpEast | wpWest;
+    byPiece[BP] = byColor[BLACK] = bpEast | bpWest;
+    twice[WHITE] = wpEast & wpWest;
+    twice[BLACK] = bpEast & bpWest;
+
+    for (Color c : COLORS) {
+        const Square enemyKingSq = pos.getKingSquare(otherColor(c));
+        const Bitboard enemyKingZone =
+            enemyKingSq == NO_SQ ? 0ull : KING_MASKS[enemyKingSq] | (1ull << enemyKingSq);
+
+        mobility[c].fill(0);
+        kingZoneAttacks[c].fill(0);
+        kingZoneAttacks[c][PAWN] = getBitCount(byPiece[ptToPiece(PAWN, c)] & enemyKingZone);
+
+        addPieceAttacks<KNIGHT>(*this, pos, c, occ, enemyKingZone);
+        addPieceAttacks<BISHOP>(*this, pos, c, occ, enemyKingZone);
+        addPieceAttacks<ROOK>(*this, pos, c, occ, enemyKingZone);
+        addPieceAttacks<QUEEN>(*this, pos, c, occ, enemyKingZone);
+        addPieceAttacks<KING>(*this, pos, c, occ, enemyKingZone);
+    }
+}
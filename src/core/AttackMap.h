@@ -0,0 +1,49 @@
+#pragma once
+
+#include "src/bitboard/bit_tools.h"
+#include "src/core/Position.h"
+#include "src/core/types.h"
+
+#include <array>
+
+/**
+ * Every square attacked in a position, built once per node with a single pass
+ * over the pieces so that the mobility and king-safety terms and quiescence's
+ * legality test can share it instead of recomputing magic lookups per piece
+ */
+struct AttackMap {
+    // squares attacked by all pieces of a kind, indexed by WP, ..., BK
+    std::array<Bitboard, NO_PIECE> byPiece {};
+
+    // squares attacked by any piece of a color
+    std::array<Bitboard, 2> byColor {};
+
+    // squares attacked by at least two pieces of a color
+    std::array<Bitboard, 2> twice {};
+
+    // number of safe squares each color's pieces can reach, indexed by color, then PieceType;
+    // squares occupied by friendly pieces or attacked by enemy pawns are excluded
+    std::array<std::array<int, NO_PT>, 2> mobility {};
+
+    // number of squares around the enemy king attacked by each color, indexed by color, then
+    // PieceType of the attacker
+    std::array<std::array<int, NO_PT>, 2> kingZoneAttacks {};
+
+    AttackMap() = default;
+
+    explicit AttackMap(const Position &pos) {
+        compute(pos);
+    }
+
+    void compute(const Position &pos);
+
+    constexpr bool isAttacked(Square sq, Color attacker) const {
+        return getBit(byColor[attacker], sq);
+    }
+
+    // true if the side that just moved left its king attacked
+    constexpr bool isIllegal(const Position &pos) const {
+        const Color stm = pos.getSideToMove();
+        return isAttacked(pos.getKingSquare(otherColor(stm)), stm);
+    }
+};
@@ -16,9 +16,17 @@ class Board {
     // indexes: WHITE, BLACK
     std::array<Bitboard, 2> occupancies;
 
+    Bitboard allPieces;
+
     // maps each square to the piece residing on it
     std::array<Piece, NO_SQ> squareToPiece;
 
+    constexpr void toggle(Piece p, Bitboard mask) {
+        pieceBBs[p] ^= mask;
+        occupancies[pieceColor(p)] ^= mask;
+        allPieces ^= mask;
+    }
+
    public:
     Board() {
         clear();
@@ -34,7 +42,7 @@ class Board {
     }
 
     constexpr Bitboard getOccupancies() const {
-        return getOccupancy(WHITE) | getOccupancy(BLACK);
+        return allPieces;
     }
 
     constexpr Bitboard getEmptySquares() const {
@@ -45,16 +53,19 @@ class Board {
         return squareToPiece[sq];
     }
 
+    // N.B: the occupancies are flipped by the same mask as the piece's bitboard, which is only
+    // correct because of the asserts on what the squares hold
+
     constexpr void addPiece(Piece p, Square sq) {
         assert(squareToPiece[sq] == NO_PIECE);
         squareToPiece[sq] = p;
-        setBit(pieceBBs[p], sq);
+        toggle(p, 1ull << sq);
     }
 
     constexpr void removePiece(Piece p, Square sq) {
         assert(squareToPiece[sq] == p);
         squareToPiece[sq] = NO_PIECE;
-        unsetBit(pieceBBs[p], sq);
+        toggle(p, 1ull << sq);
     }
 
     constexpr void movePiece(Piece p, Square from, Square to) {
@@ -62,27 +73,22 @@ class Board {
         assert(squareToPiece[to] == NO_PIECE);
         squareToPiece[from] = NO_PIECE;
         squareToPiece[to] = p;
-        pieceBBs[p] ^= (1ull << from) | (1ull << to);
+        toggle(p, (1ull << from) | (1ull << to));
     }
 
+    // N.B: only promotions and their undoing swap pieces, so the color and occupancies don't change
     constexpr void swapPiece(Square sq, Piece from, Piece to) {
         assert(squareToPiece[sq] == from);
+        assert(pieceColor(from) == pieceColor(to));
         squareToPiece[sq] = to;
-        unsetBit(pieceBBs[from], sq);
-        setBit(pieceBBs[to], sq);
-    }
-
-    // allows for updating this table only when strictly necessary
-    constexpr void updateOccupancies() {
-        occupancies[WHITE] =
-            pieceBBs[WP] | pieceBBs[WN] | pieceBBs[WB] | pieceBBs[WR] | pieceBBs[WQ] | pieceBBs[WK];
-        occupancies[BLACK] =
-            pieceBBs[BP] | pieceBBs[BN] | pieceBBs[BB] | pieceBBs[BR] | pieceBBs[BQ] | pieceBBs[BK];
+        pieceBBs[from] ^= 1ull << sq;
+        pieceBBs[to] ^= 1ull << sq;
     }
 
     void clear() {
         pieceBBs.fill(0ull);
         occupancies.fill(0ull);
+        allPieces = 0ull;
         squareToPiece.fill(NO_PIECE);
     }
 };
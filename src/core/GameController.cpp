@@ -27,17 +27,18 @@ void GameController::makeManualMove(Move move) {
     // write to PGN file BEFORE move is made
     pgnWriter.writeMove(pos, move);
 
+    // log the position being left in engine history; search adds the current one itself
+    engine.addToHashHistory(pos.getHash());
+
     // make move
     pos.makeMove(move);
 
-    // log new move in engine history
-    engine.addToHashHistory(pos.getHash());
-
     // update set of legal moves
     MoveGenerator::generateLegal(legalMoves, pos);
 }
 
 void GameController::makeAIMove() {
+    engine.resetSearchStopper();
     makeManualMove(engine.getMove(pos));
 }
 
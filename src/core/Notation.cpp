@@ -105,7 +105,7 @@ std::string getSANDisambiguation(const Move &move, Position &pos) {
     }
 
     if (!sameRank) {
-        return std::string(1, '1' + rankOf(from));
+        return std::string(1, '8' - rankOf(from));
     }
 
     return squareToCoordinateString(from);
@@ -159,4 +159,87 @@ std::string moveToSAN(const Move &move, Position &pos) {
 
     return san.str();
 }
+
+Move sanToMove(Position &pos, const std::string &san) {
+    // strip check, mate, and annotation suffixes
+    std::string s = san.substr(0, san.find_first_of("+#!?"));
+
+    MoveList legalMoves;
+    MoveGenerator::generateLegal(legalMoves, pos);
+
+    // ---- CASTLING ----
+    if (s == "O-O" || s == "0-0" || s == "O-O-O" || s == "0-0-0") {
+        const File kingFile = s.size() == 3 ? FILE_G : FILE_C;
+        for (const Move &m : legalMoves) {
+            if (m.isCastles() && fileOf(m.getToSquare()) == kingFile) {
+                return m;
+            }
+        }
+        return Move::none();
+    }
+
+    // ---- PROMOTION ----
+    PieceType promotedPT = NO_PT;
+    if (!s.empty() && std::string_view("NBRQ").find(s.back()) != std::string_view::npos) {
+        promotedPT = pieceToPT(fenCharToPiece(s.back()));
+        s.pop_back();
+        if (!s.empty() && s.back() == '=') {
+            s.pop_back();
+        }
+    }
+
+    // ---- PIECE LETTER ----
+    PieceType pt = PAWN;
+    size_t i = 0;
+    if (!s.empty() && std::string_view("NBRQK").find(s[0]) != std::string_view::npos) {
+        pt = pieceToPT(fenCharToPiece(s[0]));
+        i = 1;
+    }
+
+    // ---- DESTINATION ----
+    if (s.size() < i + 2) {
+        return Move::none();
+    }
+    const std::string dest = s.substr(s.size() - 2);
+    if (dest[0] < 'a' || dest[0] > 'h' || dest[1] < '1' || dest[1] > '8') {
+        return Move::none();
+    }
+    const Square to = coordinateStringToSquare(dest);
+
+    // ---- DISAMBIGUATION + CAPTURE ----
+    int fromFile = -1, fromRank = -1;
+    for (; i < s.size() - 2; i++) {
+        if (s[i] >= 'a' && s[i] <= 'h') {
+            fromFile = s[i] - 'a';
+        } else if (s[i] >= '1' && s[i] <= '8') {
+            fromRank = '8' - s[i];
+        } else if (s[i] != 'x' && s[i] != '-') {
+            return Move::none();
+        }
+    }
+
+    Move result = Move::none();
+    for (const Move &m : legalMoves) {
+        const Square from = m.getFromSquare();
+
+        if (m.getToSquare() != to || m.isCastles() || pieceToPT(pos.pieceAt(from)) != pt) {
+            continue;
+        }
+        if ((fromFile != -1 && fileOf(from) != fromFile) ||
+            (fromRank != -1 && rankOf(from) != fromRank)) {
+            continue;
+        }
+        if (m.isPromotion() ? m.getPromotedPieceType() != promotedPT : promotedPT != NO_PT) {
+            continue;
+        }
+
+        // ambiguous
+        if (result != Move::none()) {
+            return Move::none();
+        }
+        result = m;
+    }
+
+    return result;
+}
 };  // namespace Notation
@@ -18,4 +18,7 @@ std::string moveToUci(const Move &move);
 
 std::string moveToSAN(const Move &move, Position &pos);
 
+// returns Move::none() if san doesn't describe exactly one legal move; ignores +, #, !, ? suffixes
+Move sanToMove(Position &pos, const std::string &san);
+
 }  // namespace Notation
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "src/core/types.h"
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Fixed size position encoding for training data and test suites, which can be read in bulk
+ * without parsing. Produced by Position::pack and read by Position::unpack
+ *
+ *   bytes  0-7   occupancy of both colors
+ *   bytes  8-23  the Piece on each occupied square as a nibble, in ascending square order,
+ *                low nibble first
+ *   byte   24    bit 0 is the side to move, bits 1-4 are the castle rights
+ *   byte   25    en passant square, or NO_SQ
+ *   byte   26    halfmove clock, saturated at 255
+ *   bytes 27-31  annotations; ignored by Position
+ *
+ * N.B: fields are stored in host byte order, so files are only portable between hosts of the same
+ * endianness (in practice, little endian)
+ */
+struct PackedPosition {
+    Bitboard occupancy;
+
+    std::array<uint8_t, 16> pieces;
+
+    uint8_t flags;
+
+    uint8_t enPassantSquare;
+
+    uint8_t halfmoveClock;
+
+    // free for callers to label a position with, e.g. a training target; zeroed by pack()
+
+    // game result from white's perspective: 0 = loss, 1 = draw, 2 = win
+    uint8_t result;
+
+    // white-relative score in centipawns
+    int16_t eval;
+
+    uint16_t reserved;
+};
+
+static_assert(sizeof(PackedPosition) == 32);
+static_assert(std::is_trivially_copyable_v<PackedPosition>);
@@ -3,6 +3,7 @@
 #include "src/bitboard/Zobrist.h"
 #include "src/core/types.h"
 
+#include <algorithm>
 #include <ostream>
 #include <sstream>
 
@@ -16,6 +17,11 @@ Position::Position(const std::string &fen) {
     parseFen(fen);
 }
 
+Position::Position(const PackedPosition &packed)
+    : Position() {
+    unpack(packed);
+}
+
 void Position::parseFen(const std::string &fen) {
     // reset board and metadata
     board.clear();
@@ -49,8 +55,6 @@ void Position::parseFen(const std::string &fen) {
         }
     }
 
-    board.updateOccupancies();
-
     if (i >= n) {
         return;
     }
@@ -58,9 +62,9 @@ void Position::parseFen(const std::string &fen) {
     // 2: side to move
     if (fen[++i] == 'w') {
         sideToMove = WHITE;
+        md.hash ^= Zobrist::getSideToMoveHash();
     } else {
         sideToMove = BLACK;
-        md.hash ^= Zobrist::getSideToMoveHash();
     }
 
     // 3: castling rights (0b0000qkQK)
@@ -88,7 +92,9 @@ void Position::parseFen(const std::string &fen) {
     // 4: en passant square
     if (fen[++i] != '-') {
         md.enPassantSquare = coordinateStringToSquare(fen.substr(i, i + 2));
-        md.hash ^= Zobrist::getEnPassantHash(fileOf(md.enPassantSquare));
+        if (hasEnPassantCapture()) {
+            md.hash ^= Zobrist::getEnPassantHash(fileOf(md.enPassantSquare));
+        }
     }
 
     if (i >= n) {
@@ -106,6 +112,91 @@ void Position::parseFen(const std::string &fen) {
     // 6: fullmove number (not used)
 }
 
+bool Position::unpack(const PackedPosition &packed) {
+    auto pieceAt = [&](int i) {
+        return Piece((packed.pieces[i / 2] >> (4 * (i % 2))) & 0xF);
+    };
+
+    // validate before touching anything, since a corrupt record would index past the piece and
+    // hash tables. pack leaves the nibbles after the last piece zero, so those must be too
+    const int numPieces = getBitCount(packed.occupancy);
+    if (numPieces > 32 || packed.enPassantSquare > NO_SQ) {
+        return false;
+    }
+
+    std::array<int, NO_PIECE> pieceCounts {};
+    for (int i = 0; i < 32; i++) {
+        const Piece p = pieceAt(i);
+        if (i >= numPieces ? p != WP : p >= NO_PIECE) {
+            return false;
+        }
+        pieceCounts[p] += i < numPieces;
+    }
+
+    if (pieceCounts[WK] != 1 || pieceCounts[BK] != 1) {
+        return false;
+    }
+
+    // reset board and metadata
+    board.clear();
+    md = Metadata();
+
+    // 1: position data; one nibble per occupied square
+    int i = 0;
+    forEachSquare(packed.occupancy, [&](Square sq) {
+        const Piece p = pieceAt(i);
+
+        board.addPiece(p, sq);
+        md.hash ^= Zobrist::getPieceSquareHash(p, sq);
+        if (p == WK) {
+            md.kingSquares[WHITE] = sq;
+        }
+        if (p == BK) {
+            md.kingSquares[BLACK] = sq;
+        }
+        i++;
+    });
+
+    // 2: side to move
+    sideToMove = Color(packed.flags & 1);
+    if (sideToMove == WHITE) {
+        md.hash ^= Zobrist::getSideToMoveHash();
+    }
+
+    // 3: castling rights
+    md.castleRights = CastleRights((packed.flags >> 1) & 0xF);
+    md.hash ^= Zobrist::getCastleRightsHash(md.castleRights);
+
+    // 4: en passant square
+    md.enPassantSquare = Square(packed.enPassantSquare);
+    if (hasEnPassantCapture()) {
+        md.hash ^= Zobrist::getEnPassantHash(fileOf(md.enPassantSquare));
+    }
+
+    // 5: halfmove clock
+    md.movesSinceCapture = packed.halfmoveClock;
+    return true;
+}
+
+PackedPosition Position::pack() const {
+    PackedPosition packed {};
+
+    packed.occupancy = board.getOccupancies();
+
+    int i = 0;
+    forEachSquare(packed.occupancy, [&](Square sq) {
+        assert(i < 32);
+        packed.pieces[i / 2] |= board.pieceAt(sq) << (4 * (i % 2));
+        i++;
+    });
+
+    packed.flags = sideToMove | (md.castleRights << 1);
+    packed.enPassantSquare = md.enPassantSquare;
+    packed.halfmoveClock = std::min(md.movesSinceCapture, 255);
+
+    return packed;
+}
+
 Board Position::getBoardCopy() const {
     return board;
 }
@@ -114,6 +205,11 @@ Position::Metadata Position::makeMove(const Move &move) {
     // save metadata about this state before making move
     Metadata oldMD = md;
 
+    // remove the old en passant key while the pawns that could capture are still in place
+    if (hasEnPassantCapture()) {
+        md.hash ^= Zobrist::getEnPassantHash(fileOf(md.enPassantSquare));
+    }
+
     /*** BOARD CHANGES ***/
     const Square from = move.getFromSquare(), to = move.getToSquare();
     const Piece pieceMoved = board.pieceAt(from);
@@ -173,7 +269,8 @@ Position::Metadata Position::makeMove(const Move &move) {
         // alter board and pieceSquare piece-square hash
         // castle rights are removed in the next phase
         board.movePiece(rook, rookFrom, rookTo);
-        md.hash ^= Zobrist::getPieceSquareHash(rook, from) ^ Zobrist::getPieceSquareHash(rook, to);
+        md.hash ^= Zobrist::getPieceSquareHash(rook, rookFrom);
+        md.hash ^= Zobrist::getPieceSquareHash(rook, rookTo);
     }
 
     // move the piece to its new destination
@@ -190,55 +287,42 @@ Position::Metadata Position::makeMove(const Move &move) {
         md.hash ^= Zobrist::getPieceSquareHash(promotedPiece, to);
     }
 
-    // update occupancies now that board operations are done
-    board.updateOccupancies();
-
     /*** OTHER METADATA CHANGES ***/
 
     // king moved; prevent white castling
     if (pieceMoved == WK) {
         removeCastleRights(md.castleRights, WHITE_CASTLING);
-        md.hash ^= Zobrist::getCastleRightsHash(WHITE_CASTLING);
-        md.hash ^= Zobrist::getCastleRightsHash(md.castleRights);
     }
 
     // king moved; prevent black castling
     if (pieceMoved == BK) {
         removeCastleRights(md.castleRights, BLACK_CASTLING);
-        md.hash ^= Zobrist::getCastleRightsHash(BLACK_CASTLING);
-        md.hash ^= Zobrist::getCastleRightsHash(md.castleRights);
     }
 
     // a8 rook moved or captured; prevent black queenside castle
     if (to == a8 || (from == a8 && pieceMoved == BR)) {
         removeCastleRights(md.castleRights, BLACK_OOO);
-        md.hash ^= Zobrist::getCastleRightsHash(BLACK_OOO);
-        md.hash ^= Zobrist::getCastleRightsHash(md.castleRights);
     }
 
     // h8 rook moved or captured; prevent black kingside castle
     if (to == h8 || (from == h8 && pieceMoved == BR)) {
         removeCastleRights(md.castleRights, BLACK_OO);
-        md.hash ^= Zobrist::getCastleRightsHash(BLACK_OO);
-        md.hash ^= Zobrist::getCastleRightsHash(md.castleRights);
     }
 
     // a1 rook moed or captured; prevent white queenside castle
     if (to == a1 || (from == a1 && pieceMoved == WR)) {
         removeCastleRights(md.castleRights, WHITE_OOO);
-        md.hash ^= Zobrist::getCastleRightsHash(WHITE_OOO);
-        md.hash ^= Zobrist::getCastleRightsHash(md.castleRights);
     }
 
     // h1 rook moed or captured; prevent white kingside castle
     if (to == h1 || (from == h1 && pieceMoved == WR)) {
         removeCastleRights(md.castleRights, WHITE_OO);
-        md.hash ^= Zobrist::getCastleRightsHash(WHITE_OO);
-        md.hash ^= Zobrist::getCastleRightsHash(md.castleRights);
     }
 
-    // update en passant square
-    int oldEpSqFile = fileOf(md.enPassantSquare);
+    // N.B: castle right keys are xor combinations, so this removes exactly the lost rights
+    md.hash ^= Zobrist::getCastleRightsHash(CastleRights(oldMD.castleRights ^ md.castleRights));
+
+    // update en passant square; it is hashed after turns change
     if (pieceMoved == WP && from + 2 * NORTH == to) {
         // white pawn moved 2 squares
         md.enPassantSquare = Square(+from + NORTH);
@@ -249,8 +333,6 @@ Position::Metadata Position::makeMove(const Move &move) {
         // ensure no stale en passant squares
         md.enPassantSquare = NO_SQ;
     }
-    md.hash ^= Zobrist::getEnPassantHash(oldEpSqFile);
-    md.hash ^= Zobrist::getEnPassantHash(fileOf(md.enPassantSquare));
 
     // update capturedPiece; this will be NONE if there was no capture
     md.capturedPiece = capturedPiece;
@@ -271,6 +353,10 @@ Position::Metadata Position::makeMove(const Move &move) {
     sideToMove = otherColor(sideToMove);
     md.hash ^= Zobrist::getSideToMoveHash();
 
+    if (hasEnPassantCapture()) {
+        md.hash ^= Zobrist::getEnPassantHash(fileOf(md.enPassantSquare));
+    }
+
     return oldMD;
 }
 
@@ -339,9 +425,6 @@ void Position::unmakeMove(const Move &move, const Metadata &prevMD) {
         board.addPiece(md.capturedPiece, capturedSq);
     }
 
-    // update occupancies now that the board is restored
-    board.updateOccupancies();
-
     // restore metadata
     md = prevMD;
 }
@@ -351,11 +434,12 @@ std::string Position::toFenString() const {
     std::ostringstream fen;
 
     // 1. Board
-    for (int rank = 7; rank >= 0; rank--) {
+    // N.B: row 0 is the 8th rank, which is also the first rank in a FEN string
+    for (int row = 0; row < 8; row++) {
         int emptyCount = 0;
 
         for (int file = 0; file < 8; file++) {
-            Square sq = xyToSquare(file, rank);
+            Square sq = xyToSquare(file, row);
             Piece p = pieceAt(sq);
 
             if (p == NO_PIECE) {
@@ -373,7 +457,7 @@ std::string Position::toFenString() const {
             fen << emptyCount;
         }
 
-        if (rank > 0) {
+        if (row < 7) {
             fen << '/';
         }
     }
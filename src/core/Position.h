@@ -3,6 +3,7 @@
 #include "src/bitboard/Magic.h"
 #include "src/core/Board.h"
 #include "src/core/Move.h"
+#include "src/core/PackedPosition.h"
 #include "src/core/types.h"
 
 #include <string>
@@ -21,7 +22,7 @@ class Position {
      *            = 24 bytes after padding
      */
     struct Metadata {
-        // maintained by ZobristHasher
+        // Zobrist hash, equal to the position's Polyglot key
         uint64_t hash = 0ull;
 
         // the last move (that led to this postion) captured this piece
@@ -52,6 +53,9 @@ class Position {
 
     Position(const std::string &fen);
 
+    // N.B: a corrupt record gives an empty board; use unpack to detect it
+    explicit Position(const PackedPosition &packed);
+
     // Getters
     constexpr const Board &getBoard() const {
         return board;
@@ -159,12 +163,31 @@ class Position {
         return isAttacked(md.kingSquares[defender], otherColor(defender));
     }
 
+    // true if the side to move has a pawn attacking the en passant square, legal or not
+    constexpr bool hasEnPassantCapture() const {
+        return md.enPassantSquare != NO_SQ &&
+               (PAWN_ATTACK_MASKS[otherColor(sideToMove)][md.enPassantSquare] &
+                getPieceBB(ptToPiece(PAWN, sideToMove)));
+    }
+
     /**
      * Parses a FEN string and updates member vars, including metadata,
      * with its contents
      */
     void parseFen(const std::string &fen);
 
+    /**
+     * Replaces the current position with a packed one, including metadata.
+     * The packed position's annotations are ignored
+     *
+     * @return false, leaving the position unchanged, if the record is corrupt: an unknown piece,
+     * more than 32 pieces, not exactly one king per side or an invalid en passant square
+     */
+    bool unpack(const PackedPosition &packed);
+
+    // N.B: assumes at most 32 pieces, which holds for any legal position
+    PackedPosition pack() const;
+
     /**
      * Makes a move in the current position
      *
@@ -0,0 +1,48 @@
+#include "UciOutput.h"
+
+#include <cerrno>
+#include <mutex>
+#include <unistd.h>
+
+// N.B: reserved once, so formatting a line doesn't allocate
+static std::string &threadBuffer() {
+    thread_local std::string buffer = [] {
+        std::string s;
+        s.reserve(4096);
+        return s;
+    }();
+    return buffer;
+}
+
+UciOutput::UciOutput()
+    : buffer(threadBuffer()), writeOnDestroy(true) {
+    buffer.clear();
+}
+
+UciOutput::UciOutput(std::string &out)
+    : buffer(out), writeOnDestroy(false) {}
+
+UciOutput::~UciOutput() {
+    buffer += '\n';
+    if (writeOnDestroy) {
+        write(buffer);
+        buffer.clear();
+    }
+}
+
+void UciOutput::write(std::string_view text) {
+    static std::mutex mtx;
+    std::lock_guard<std::mutex> lock(mtx);
+
+    // N.B: a pipe can take less than everything, or the write can be interrupted by a signal
+    while (!text.empty()) {
+        const ssize_t written = ::write(STDOUT_FILENO, text.data(), text.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        text.remove_prefix(written);
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * Formats one line of engine output and writes it to stdout when destroyed
+ *
+ * Lines are built in a buffer that each thread reuses, then written with a single write(2) under a
+ * mutex, so lines from the search and UCI threads can't interleave and there's one syscall per
+ * line instead of a flush per std::endl. Meant to be used as a temporary:
+ *
+ *     UciOutput() << "info depth " << depth;
+ */
+class UciOutput {
+   private:
+    std::string &buffer;
+
+    // whether the line is written on destruction, or left in a caller's buffer
+    bool writeOnDestroy;
+
+   public:
+    UciOutput();
+
+    // appends the line to out instead of writing it, for output that is held back and written later
+    explicit UciOutput(std::string &out);
+
+    UciOutput(const UciOutput &) = delete;
+    UciOutput &operator=(const UciOutput &) = delete;
+
+    ~UciOutput();
+
+    UciOutput &operator<<(std::string_view text) {
+        buffer += text;
+        return *this;
+    }
+
+    UciOutput &operator<<(char c) {
+        buffer += c;
+        return *this;
+    }
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    UciOutput &operator<<(T value) {
+        char digits[24];
+        const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, result.ptr);
+        return *this;
+    }
+
+    // writes text, which may be several lines, to stdout at once
+    static void write(std::string_view text);
+};
@@ -433,7 +433,10 @@ inline constexpr void removeCastleRights(CastleRights &current, CastleRights toR
 // file paths and GUI Constants
 constexpr std::string_view PGN_OUTPUT_PATH = "../games/";
 constexpr std::string_view DEFAULT_OUT_FILE = "../games/recent.pgn";
-constexpr std::string_view OPENING_BOOK_FILE = "../openings/baron30.bin";
+constexpr std::string_view OPENINGS_PATH = "../openings/";
+// opening books probed by the engine, highest priority first
+constexpr std::string_view DEFAULT_BOOK_FILES =
+    "../openings/Perfect2023.bin;../openings/baron30.bin";
 constexpr std::string_view SFX_PATH = "../src/assets/sfx/";
 constexpr std::string_view PIECE_TEXTURE_PATH = "../src/assets/pieces/";
 constexpr std::string_view BOARD_TEXTURE_FILE = "../src/assets/board.png";
@@ -0,0 +1,220 @@
+#include "DataGenerator.h"
+
+#include "src/ai/search/NodeSearchStopper.h"
+#include "src/ai/search/Searcher.h"
+#include "src/core/MoveList.h"
+#include "src/core/PositionUtil.h"
+#include "src/movegen/MoveGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+
+// iterative deepening runs until the node limit stops it
+static constexpr int MAX_SEARCH_DEPTH = 64;
+
+static uint32_t randomBelow(PRNG &rng, uint32_t n) {
+    return static_cast<uint32_t>(rng.next() >> 32) % n;
+}
+
+// history holds every position since the last irreversible move, including the current one
+static bool isThreefoldRepetition(const std::vector<uint64_t> &history) {
+    return std::count(history.begin(), history.end(), history.back()) >= 3;
+}
+
+static void playMove(Position &pos, const Move &move, std::vector<uint64_t> &history) {
+    pos.makeMove(move);
+
+    if (pos.getMetadata().movesSinceCapture == 0) {
+        history.clear();
+    }
+    history.push_back(pos.getHash());
+}
+
+DataGenerator::DataGenerator(const Options &options, DataWriter &writer)
+    : options(options), writer(writer) {}
+
+int DataGenerator::loadBooks(const std::string &dir) {
+    std::vector<std::filesystem::path> paths;
+
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(dir, ec)) {
+        if (entry.path().extension() == ".bin") {
+            paths.push_back(entry.path());
+        }
+    }
+
+    if (ec) {
+        std::cerr << "Failed to read book directory: " << dir << "\n";
+    }
+
+    // sorted so that a given seed always produces the same games
+    std::sort(paths.begin(), paths.end());
+
+    for (const std::filesystem::path &path : paths) {
+        auto book = std::make_unique<PolyglotBook>(path.string());
+        if (book->size() > 0) {
+            std::cout << "Loaded " << book->size() << " entries from " << path.string() << "\n";
+            books.push_back(std::move(book));
+        }
+    }
+
+    return books.size();
+}
+
+bool DataGenerator::playOpening(Position &pos, std::vector<uint64_t> &history, PRNG &rng) const {
+    MoveList legalMoves;
+
+    if (!books.empty()) {
+        const PolyglotBook &book = *books[randomBelow(rng, books.size())];
+        const int span = options.maxBookPlies - options.minBookPlies + 1;
+        const int bookPlies = options.minBookPlies + randomBelow(rng, std::max(span, 1));
+
+        for (int ply = 0; ply < bookPlies; ply++) {
+            const Move move = book.getMove(pos, rng);
+
+            // out of book; continue from here
+            if (move == Move::none()) {
+                break;
+            }
+
+            // guard against key collisions and malformed entries
+            legalMoves.clear();
+            MoveGenerator::generateLegal(legalMoves, pos);
+            if (!legalMoves.has(move)) {
+                break;
+            }
+
+            playMove(pos, move, history);
+        }
+    }
+
+    for (int ply = 0; ply < options.randomPlies; ply++) {
+        legalMoves.clear();
+        MoveGenerator::generateLegal(legalMoves, pos);
+        if (legalMoves.empty()) {
+            return false;
+        }
+
+        playMove(pos, legalMoves[randomBelow(rng, legalMoves.size())], history);
+    }
+
+    return !PositionUtil::isTerminal(pos);
+}
+
+void DataGenerator::playGames(int workerId) {
+    PRNG rng(options.seed + 7919 * workerId);
+
+    NodeSearchStopper stopper(options.nodeLimit);
+    Searcher searcher(&stopper);
+    searcher.setPrintInfo(false);
+
+    std::vector<PackedPosition> records;
+    std::vector<uint64_t> history;
+    MoveList legalMoves;
+
+    while (gamesStarted.fetch_add(1) < options.numGames) {
+        Position pos;
+
+        // retry until the opening leaves a playable position
+        do {
+            pos = Position(std::string(STARTING_POSITION_FEN));
+            history.assign(1, pos.getHash());
+        } while (!playOpening(pos, history, rng));
+
+        records.clear();
+        DataResult result = DRAW;
+
+        for (int ply = 0;; ply++) {
+            const Color us = pos.getSideToMove();
+
+            legalMoves.clear();
+            MoveGenerator::generateLegal(legalMoves, pos);
+
+            if (legalMoves.empty()) {
+                if (pos.isCheck()) {
+                    result = us == WHITE ? BLACK_WIN : WHITE_WIN;
+                }
+                break;
+            }
+
+            if (ply >= options.maxGamePlies || isThreefoldRepetition(history) ||
+                PositionUtil::is50MoveRuleDraw(pos) || PositionUtil::insufficientMaterial(pos)) {
+                break;
+            }
+
+            // the searcher only needs the positions that can still repeat
+            searcher.clearRepetitionTable();
+            for (size_t i = 0; i + 1 < history.size(); i++) {
+                searcher.addToRepetitionTable(history[i]);
+            }
+
+            stopper.reset();
+            const Move best = searcher.run(pos, MAX_SEARCH_DEPTH);
+            const Eval score = searcher.getLastScore();
+
+            // adjudicate once either side finds a forced mate
+            if (abs(score) >= MATE_BOUND) {
+                const bool weWin = score > 0;
+                result = (us == WHITE) == weWin ? WHITE_WIN : BLACK_WIN;
+                break;
+            }
+
+            // only keep quiet positions, whose static eval should match the search score
+            const bool isQuiet = !pos.isCheck() && pos.pieceAt(best.getToSquare()) == NO_PIECE &&
+                                 !best.isPromotion() && !best.isEnPassant();
+            if (isQuiet) {
+                PackedPosition record = pos.pack();
+                record.eval = std::clamp(SIGN[us] * score, -32000, 32000);
+                records.push_back(record);
+            }
+
+            playMove(pos, best, history);
+        }
+
+        writer.write(records, result);
+        gamesFinished++;
+    }
+}
+
+void DataGenerator::run() {
+    const int numThreads = std::max(1, options.numThreads);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; i++) {
+        threads.emplace_back(&DataGenerator::playGames, this, i);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto lastReport = start;
+
+    while (gamesFinished < options.numGames) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastReport < std::chrono::seconds(10)) {
+            continue;
+        }
+        lastReport = now;
+
+        const double seconds = std::chrono::duration<double>(now - start).count();
+        const uint64_t positions = writer.getRecordsWritten();
+
+        std::cout << "games " << gamesFinished << "/" << options.numGames << " positions "
+                  << positions << " (" << static_cast<uint64_t>(positions / seconds) << "/s)"
+                  << std::endl;
+    }
+
+    for (std::thread &th : threads) {
+        th.join();
+    }
+
+    writer.flush();
+
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Wrote " << writer.getRecordsWritten() << " positions from " << gamesFinished
+              << " games in " << static_cast<int>(seconds) << " s" << std::endl;
+}
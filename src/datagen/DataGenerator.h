@@ -0,0 +1,65 @@
+#pragma once
+
+#include "src/ai/PolyglotBook.h"
+#include "src/bitboard/PRNG.h"
+#include "src/datagen/DataWriter.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Plays fixed-node self-play games and records (position, eval, result) for every quiet position
+ *
+ * Each worker thread owns its own Searcher, and therefore its own TT, so workers share nothing
+ * but the read-only opening books, the game counter, and the writer
+ */
+class DataGenerator {
+   public:
+    struct Options {
+        int numThreads = 1;
+
+        uint64_t numGames = 10000;
+
+        // nodes searched per move
+        uint64_t nodeLimit = 5000;
+
+        // games are stopped after a random number of book moves in [min, max]
+        int minBookPlies = 4;
+        int maxBookPlies = 16;
+
+        // uniformly random moves played after leaving the book, for variety
+        int randomPlies = 2;
+
+        // games still running after this many plies are adjudicated as draws
+        int maxGamePlies = 400;
+
+        uint32_t seed = 1;
+    };
+
+   private:
+    Options options;
+
+    std::vector<std::unique_ptr<PolyglotBook>> books;
+
+    DataWriter &writer;
+
+    std::atomic<uint64_t> gamesStarted = 0;
+
+    std::atomic<uint64_t> gamesFinished = 0;
+
+    // returns false if the opening ended the game or no book had a move for the start position
+    bool playOpening(Position &pos, std::vector<uint64_t> &history, PRNG &rng) const;
+
+    void playGames(int workerId);
+
+   public:
+    DataGenerator(const Options &options, DataWriter &writer);
+
+    // loads every .bin book in dir; returns the number of books loaded
+    int loadBooks(const std::string &dir);
+
+    // blocks until options.numGames games are written, printing progress along the way
+    void run();
+};
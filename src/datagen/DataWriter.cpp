@@ -0,0 +1,48 @@
+#include "DataWriter.h"
+
+#include <iostream>
+
+DataWriter::DataWriter(const std::string &path)
+    : file(path, std::ios::binary | std::ios::app) {
+    if (!file) {
+        std::cerr << "Failed to open output file: " << path << "\n";
+    }
+
+    buffer.reserve(FLUSH_THRESHOLD);
+}
+
+DataWriter::~DataWriter() {
+    flush();
+}
+
+void DataWriter::write(const std::vector<PackedPosition> &records, DataResult result) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (PackedPosition record : records) {
+        record.result = result;
+        buffer.push_back(record);
+    }
+
+    recordsWritten += records.size();
+
+    if (buffer.size() >= FLUSH_THRESHOLD) {
+        flushLocked();
+    }
+}
+
+void DataWriter::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    flushLocked();
+}
+
+void DataWriter::flushLocked() {
+    file.write(reinterpret_cast<const char *>(buffer.data()),
+               buffer.size() * sizeof(PackedPosition));
+    file.flush();
+    buffer.clear();
+}
+
+uint64_t DataWriter::getRecordsWritten() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return recordsWritten;
+}
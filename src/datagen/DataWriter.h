@@ -0,0 +1,50 @@
+#pragma once
+
+#include "src/core/PackedPosition.h"
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// game result from white's perspective, as stored in PackedPosition::result
+enum DataResult : uint8_t { BLACK_WIN, DRAW, WHITE_WIN };
+
+/**
+ * Appends self-play records to a binary file. Each record is a 32 byte PackedPosition whose eval
+ * annotation holds the search score and whose result annotation holds the DataResult
+ *
+ * Records are buffered and written out in large blocks; write() may be called from any thread
+ */
+class DataWriter {
+   private:
+    // flush once the buffer holds this many records (1 MB)
+    static constexpr size_t FLUSH_THRESHOLD = (1 << 20) / sizeof(PackedPosition);
+
+    std::ofstream file;
+
+    std::vector<PackedPosition> buffer;
+
+    std::mutex mutex;
+
+    uint64_t recordsWritten = 0;
+
+    void flushLocked();
+
+   public:
+    explicit DataWriter(const std::string &path);
+
+    ~DataWriter();
+
+    bool isOpen() const {
+        return file.is_open();
+    }
+
+    // writes every record of a finished game, all labelled with the game's result
+    void write(const std::vector<PackedPosition> &records, DataResult result);
+
+    void flush();
+
+    uint64_t getRecordsWritten();
+};
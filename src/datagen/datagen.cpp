@@ -0,0 +1,51 @@
+#include "src/datagen/DataGenerator.h"
+#include "src/datagen/DataWriter.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <thread>
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: ./datagen <output file> [games] [nodes per move] [threads] [seed]\n"
+                     "Opening books are read from every .bin file in "
+                  << OPENINGS_PATH << std::endl;
+        return 1;
+    }
+
+    DataGenerator::Options options;
+    options.numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    const std::string output = argv[1];
+    if (argc > 2) {
+        options.numGames = std::stoull(argv[2]);
+    }
+    if (argc > 3) {
+        options.nodeLimit = std::stoull(argv[3]);
+    }
+    if (argc > 4) {
+        options.numThreads = std::max(1, std::stoi(argv[4]));
+    }
+    if (argc > 5) {
+        options.seed = std::stoul(argv[5]);
+    }
+
+    DataWriter writer(output);
+    if (!writer.isOpen()) {
+        return 1;
+    }
+
+    DataGenerator generator(options, writer);
+    const int numBooks = generator.loadBooks(std::string(OPENINGS_PATH));
+    if (numBooks == 0) {
+        std::cerr << "No opening books found; games will start from random moves only\n";
+    }
+
+    std::cout << "Playing " << options.numGames << " games at " << options.nodeLimit
+              << " nodes per move on " << options.numThreads << " threads" << std::endl;
+
+    generator.run();
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "Bench.h"
+
+#include "src/ai/search/NodeSearchStopper.h"
+#include "src/ai/search/Searcher.h"
+#include "src/core/Position.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <string_view>
+
+namespace {
+
+// openings, middlegames with both castled and opposite kings, and endgames down to a few pieces
+// N.B: changing this list changes the signature
+constexpr std::array<std::string_view, 50> BENCH_POSITIONS = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11",
+    "4rrk1/pp1n3p/3q2pQ/2p1pb2/2PP4/2P3N1/P2B2PP/4RRK1 b - - 7 19",
+    "rq3rk1/ppp2ppp/1bnpb3/3N2B1/3NP3/7P/PPPQ1PP1/2KR3R w - - 7 14",
+    "r1bq1r1k/1pp1n1pp/1p1p4/4p2Q/4Pp2/1BNP4/PPP2PPP/3R1RK1 w - - 2 14",
+    "r3r1k1/2p2ppp/p1p1bn2/8/1q2P3/2NPQN2/PPP3PP/R4RK1 b - - 2 15",
+    "r1bbk1nr/pp3p1p/2n5/1N4p1/2Np1B2/8/PPP2PPP/2KR1B1R w kq - 0 13",
+    "r1bq1rk1/ppp1nppp/4n3/3p3Q/3P4/1BP1B3/PP1N2PP/R4RK1 w - - 1 16",
+    "4r1k1/r1q2ppp/ppp2n2/4P3/5Rb1/1N1BQ3/PPP3PP/R5K1 w - - 1 17",
+    "2rqkb1r/ppp2p2/2npb1p1/1N1Nn2p/2P1PP2/8/PP2B1PP/R1BQK2R b KQ - 0 11",
+    "r1bq1r1k/b1p1npp1/p2p3p/1p6/3PP3/1B2NN2/PP3PPP/R2Q1RK1 w - - 1 16",
+    "3r1rk1/p5pp/bpp1pp2/8/q1PP1P2/b3P3/P2NQRPP/1R2B1K1 b - - 6 22",
+    "r1q2rk1/2p1bppp/2Pp4/p6b/Q1PNp3/4B3/PP1R1PPP/2K4R w - - 2 18",
+    "4k2r/1pb2ppp/1p2p3/1R1p4/3P4/2r1PN2/P4PPP/1R4K1 b - - 3 22",
+    "3q2k1/pb3p1p/4pbp1/2r5/PpN2N2/1P2P2P/5PP1/Q2R2K1 b - - 4 26",
+    "6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/8 b - - 3 54",
+    "3r2k1/1p3ppp/2pq4/p1n5/P6P/1P6/1PB2QP1/1K2R3 w - - 0 30",
+    "2r5/8/1n6/1P1p1pkp/p2P4/R1P1PKP1/8/1R6 w - - 13 47",
+    "r2r1n2/pp2bk2/2p1p2p/3q4/3PN1QP/2P3R1/P4PP1/5RK1 w - - 0 1",
+    "6k1/3b3r/1p1p4/p1n2p2/1PPNpP1q/P3Q1p1/1R1RB1P1/5K2 b - - 0 1",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "rnbqkb1r/pp2pppp/3p1n2/8/3NP3/8/PPP2PPP/RNBQKB1R w KQkq - 1 5",
+    "rnbqk2r/ppp1ppbp/3p1np1/8/2PPP3/2N5/PP3PPP/R1BQKBNR w KQkq - 1 5",
+    "r1bqk2r/2ppbppp/p1n2n2/1p2p3/4P3/1B3N2/PPPP1PPP/RNBQR1K1 b kq - 1 7",
+    "rnbq1rk1/pp2ppbp/3p1np1/8/3NP3/2N1BP2/PPPQ2PP/R3KB1R b KQ - 2 8",
+    "r2qkb1r/pp1n1ppp/2p1pn2/3p1b2/2PP4/1QN1PN2/PP3PPP/R1B1KB1R w KQkq - 2 7",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "2kr3r/pp1q1ppp/2n1pn2/3p4/1b1P4/2NBPN2/PP1Q1PPP/R3K2R w KQ - 4 12",
+    "r1b2rk1/pp1nqppp/2p1pn2/3p4/2PP4/2NBPN2/PPQ2PPP/R3K2R w KQ - 2 10",
+    "2r2rk1/pp3ppp/2n1pn2/q2p4/3P4/P1PBPN2/4QPPP/R1R3K1 b - - 3 16",
+    "r3kb1r/1b3ppp/p3pn2/1pnq4/3N4/2N1B3/PPP1BPPP/R2QK2R w KQkq - 2 12",
+    "1k1r3r/pp2bppp/2n1pn2/q2p4/3P4/P1N1PN2/1PQBBPPP/R4RK1 w - - 0 13",
+    "r4rk1/pp1b1ppp/1q2pn2/3p4/1b1P4/2NBPN2/PP3PPP/R2Q1RK1 w - - 4 12",
+    "8/pp3k2/2p1rp1p/3r2p1/3P4/2P1R1P1/PP3PKP/4R3 w - - 2 30",
+    "5rk1/5ppp/4p3/8/1P1P4/4P3/5PPP/2R3K1 w - - 0 30",
+    "8/5pk1/6p1/3R4/5P2/r5PK/8/8 w - - 0 50",
+    "8/8/4k3/3p4/3P1K2/8/8/8 w - - 0 60",
+    "8/8/1p1k4/p1pP4/P1P1K3/8/8/8 w - - 0 45",
+    "8/8/5k2/4N3/2B5/8/8/4K3 w - - 0 70",
+    "8/8/3k4/8/2PK4/8/8/8 w - - 0 1",
+    "8/8/8/5N2/8/p7/8/2NK3k w - - 0 1",
+    "8/3k4/8/8/8/4B3/4KB2/2B5 w - - 0 1",
+    "8/8/1P6/5pr1/8/4R3/7k/2K5 w - - 0 1",
+    "8/2p4P/8/kr6/6R1/8/8/1K6 w - - 0 1",
+    "8/8/3P3k/8/1p6/8/1P6/1K3n2 b - - 0 1",
+    "8/R7/2q5/8/6k1/8/1P5p/K6R w - - 0 124",
+    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+    "8/8/8/8/3k4/8/3K4/4Q3 w - - 0 1",
+    "8/8/8/8/8/5k2/6p1/6K1 w - - 0 1",
+};
+
+}  // namespace
+
+namespace Bench {
+
+bool run(int depth, int threads, size_t hashMb) {
+    if (depth < 1 || depth > MAX_PLY || threads < 1 || hashMb < 1 ||
+        hashMb > TranspositionTable::MAX_SIZE_MB) {
+        std::cerr << "Usage: ./sockfish bench [depth >= 1] [threads >= 1] [hash 1.."
+                  << TranspositionTable::MAX_SIZE_MB << " MB]" << std::endl;
+        return false;
+    }
+
+    // N.B: accepted so scripts written for other engines work, but search is single threaded
+    if (threads > 1) {
+        std::cerr << "Search is single threaded; ignoring threads = " << threads << std::endl;
+    }
+
+    NodeSearchStopper stopper(SearchStopper::NO_NODE_LIMIT);
+    Searcher searcher(&stopper);
+    searcher.setPrintInfo(false);
+    searcher.setHashSize(hashMb);
+
+    uint64_t totalNodes = 0;
+    SearchStats totalStats;
+    std::chrono::steady_clock::duration totalTime {};
+
+    for (size_t i = 0; i < BENCH_POSITIONS.size(); i++) {
+        Position pos {std::string(BENCH_POSITIONS[i])};
+
+        // every position is searched as if it were the first, so the order doesn't matter
+        searcher.clearHash();
+        searcher.clearRepetitionTable();
+
+        const auto start = std::chrono::steady_clock::now();
+        stopper.reset();
+        searcher.run(pos, depth);
+        totalTime += std::chrono::steady_clock::now() - start;
+
+        totalNodes += searcher.getNodesSearched();
+        totalStats += searcher.getStats();
+        std::cerr << "Position " << i + 1 << '/' << BENCH_POSITIONS.size() << ": "
+                  << searcher.getNodesSearched() << " nodes" << std::endl;
+    }
+
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(totalTime).count();
+    const uint64_t nps = totalNodes * 1000 / std::max<int64_t>(ms, 1);
+
+    std::cout << "===========================\n"
+              << "Total time (ms) : " << ms << '\n'
+              << "Nodes searched  : " << totalNodes << '\n'
+              << "Nodes/second    : " << nps << std::endl;
+
+    if constexpr (SEARCH_STATS_ENABLED) {
+        totalStats.print(std::cout, totalNodes);
+    }
+
+    return true;
+}
+
+}  // namespace Bench
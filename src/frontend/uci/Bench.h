@@ -0,0 +1,21 @@
+#pragma once
+
+#include "src/ai/TranspositionTable.h"
+
+#include <cstddef>
+
+namespace Bench {
+
+constexpr int DEFAULT_DEPTH = 5;
+
+/**
+ * Searches a fixed suite of positions to a fixed depth and prints the total nodes, time and NPS
+ *
+ * Every position starts from a cleared hash table with no history, so the node count only changes
+ * when search does and serves as a signature for functional changes. Returns false if the
+ * arguments are out of range
+ */
+bool run(int depth = DEFAULT_DEPTH, int threads = 1,
+         size_t hashMb = TranspositionTable::DEFAULT_SIZE_MB);
+
+}  // namespace Bench
@@ -1,8 +1,12 @@
 #include "UciFrontend.h"
 
+#include "src/core/MoveList.h"
 #include "src/core/Notation.h"
+#include "src/core/UciOutput.h"
 #include "src/core/types.h"
+#include "src/movegen/MoveGenerator.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <thread>
@@ -19,22 +23,39 @@ void UciFrontend::searchWorker() {
             break;
         }
 
+        // N.B: reset the flag before searching; a "go" sent as soon as bestmove is printed would
+        // otherwise be cleared and never run
+        const int depth = searchDepth;
+        searchDepth = -1;
+        searching = true;
+
+        const bool useBook = useOwnBook && !hasSearchMoves;
+
         // unlock while searching to allow parsing commands in UCI loop
         lock.unlock();
 
-        Move best = useOwnBook ? engine.getMove(pos, searchDepth)
-                               : engine.getSearchedMove(pos, searchDepth);
-        std::cout << "bestmove " << Notation::moveToUci(best) << std::endl;
+        Move best = useBook ? engine.getMove(pos, depth) : engine.getSearchedMove(pos, depth);
 
         lock.lock();
 
-        // reset flag
-        searchDepth = -1;
+        // ponder and infinite searches can end by themselves, e.g. at their depth limit, but
+        // bestmove may only be sent after "ponderhit" or "stop"
+        cv.wait(lock, [this] { return (!pondering && !infinite) || terminateWorker; });
+
+        // N.B: the lock is held until bestmove is written, so nothing sees this before then
+        searching = false;
+
+        UciOutput out;
+        out << "bestmove " << Notation::moveToUci(best);
+        if (engine.getPonderMove() != Move::none()) {
+            out << " ponder " << Notation::moveToUci(engine.getPonderMove());
+        }
     }
 }
 
-int UciFrontend::calculateTimeToMove(int remainingTime, int increment) {
-    return remainingTime / 15 + increment / 2;
+bool UciFrontend::isSearching() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return searching || searchDepth != -1;
 }
 
 void UciFrontend::run() {
@@ -50,87 +71,157 @@ void UciFrontend::run() {
 
         // -------- UCI handshake --------
         if (cmd == "uci") {
-            std::cout << "id name Sockfish" << std::endl;
-            std::cout << "id author Jon Klein" << std::endl;
-            std::cout << "option name OwnBook type check default true" << std::endl;
-            std::cout << "uciok" << std::endl;
+            UciOutput() << "id name Sockfish";
+            UciOutput() << "id author Jon Klein";
+            UciOutput() << "option name OwnBook type check default true";
+            UciOutput() << "option name BookFile type string default " << DEFAULT_BOOK_FILES;
+            UciOutput() << "option name BookDepth type spin default "
+                        << OpeningBook::DEFAULT_MAX_PLY << " min 0 max 1000";
+            UciOutput() << "option name Move Overhead type spin default "
+                        << TimeManager::DEFAULT_MOVE_OVERHEAD << " min 0 max 5000";
+            // N.B: the GUI decides when to ponder, so the option only tells it that we can
+            UciOutput() << "option name Ponder type check default false";
+            UciOutput() << "option name MultiPV type spin default 1 min 1 max 256";
+            UciOutput() << "option name Hash type spin default "
+                        << TranspositionTable::DEFAULT_SIZE_MB << " min 1 max "
+                        << TranspositionTable::MAX_SIZE_MB;
+            UciOutput() << "option name Clear Hash type button";
+            UciOutput() << "option name Hash File type string default " << DEFAULT_HASH_FILE;
+            UciOutput() << "option name Shared Hash type string default <empty>";
+            UciOutput() << "uciok";
         }
 
         // -------- Set Option command --------
         else if (cmd == "setoption") {
-            std::string name;
-            ss >> name;
-            if (name != "name") {
+            std::string token;
+            ss >> token;
+            if (token != "name") {
                 continue;
             }
 
-            std::string option;
-            ss >> option;
+            // option names and values may both contain spaces
+            std::string option, value;
+            while (ss >> token && token != "value") {
+                option += option.empty() ? token : " " + token;
+            }
+            std::getline(ss >> std::ws, value);
 
             if (option == "OwnBook") {
-                std::string value;
-                ss >> value;
-                if (value != "value") {
-                    continue;
-                }
-
-                std::string checked;
-                ss >> checked;
-                if (checked == "false") {
-                    useOwnBook = false;
+                useOwnBook = value == "true";
+            } else if (option == "BookFile") {
+                // book files separated by ';', highest priority first
+                engine.setBookFiles(value);
+            } else if (option == "BookDepth") {
+                engine.setBookDepth(std::stoi(value));
+            } else if (option == "Move Overhead") {
+                timeManager.setMoveOverhead(std::stoi(value));
+            } else if (option == "MultiPV") {
+                engine.setMultiPV(std::stoi(value));
+            } else if (option == "Hash File") {
+                hashFile = value;
+            } else if (option == "Shared Hash") {
+                // the name of a shared memory segment; processes given the same one share a table
+                const std::string name = value == "<empty>" ? "" : value;
+                if (!engine.shareHash(name)) {
+                    UciOutput() << "info string failed to share hash as " << name;
                 }
+            } else if (option == "Clear Hash") {
+                engine.clearHash();
+            } else if (option == "Hash") {
+                const size_t sizeMb = std::stoull(value);
+                engine.setHashSize(std::clamp<size_t>(sizeMb, 1, TranspositionTable::MAX_SIZE_MB));
             }
         }
 
         // -------- Ready command --------
         else if (cmd == "isready") {
-            std::cout << "readyok" << std::endl;
+            UciOutput() << "readyok";
+        }
+
+        // -------- Hash table persistence --------
+        // N.B: not standard UCI, so GUIs and scripts may send these at any time; the search reads
+        // the table without locks, so they're refused until it has finished
+        else if ((cmd == "savehash" || cmd == "loadhash") && isSearching()) {
+            UciOutput() << "info string can't " << cmd << " while searching";
+        } else if (cmd == "savehash") {
+            if (engine.saveHash(hashFile)) {
+                UciOutput() << "info string saved hash to " << hashFile;
+            } else {
+                UciOutput() << "info string failed to save hash to " << hashFile;
+            }
+        } else if (cmd == "loadhash") {
+            if (engine.loadHash(hashFile)) {
+                UciOutput() << "info string loaded hash from " << hashFile;
+            } else {
+                UciOutput() << "info string failed to load hash from " << hashFile;
+            }
         }
 
         // -------- New game --------
         else if (cmd == "ucinewgame") {
             pos.parseFen(std::string(STARTING_POSITION_FEN));
+            engine.newGame();
+
+            // the next "position" command can't continue from the last game
+            lastPosition.clear();
         }
 
         // -------- Position command --------
         else if (cmd == "position") {
-            std::string type;
-            ss >> type;
-
-            if (type == "startpos") {
-                pos.parseFen(std::string(STARTING_POSITION_FEN));
-            } else if (type == "fen") {
-                std::string fen, tmp;
-                fen = "";
-
-                // FEN is exactly 6 space-separated fields
-                for (int i = 0; i < 6; i++) {
-                    ss >> tmp;
-                    fen += tmp + " ";
+            // during a game each command repeats the last one and appends a move or two, so only
+            // the new moves are applied; anything else sets the position up from scratch
+            const bool extendsLast = !lastPosition.empty() && line.size() >= lastPosition.size() &&
+                                     line.compare(0, lastPosition.size(), lastPosition) == 0 &&
+                                     (line.size() == lastPosition.size() ||
+                                      line[lastPosition.size()] == ' ');
+
+            if (extendsLast) {
+                ss.seekg(lastPosition.size());
+            } else {
+                std::string type;
+                ss >> type;
+
+                if (type == "startpos") {
+                    pos.parseFen(std::string(STARTING_POSITION_FEN));
+                } else if (type == "fen") {
+                    std::string fen, tmp;
+                    fen = "";
+
+                    // FEN is exactly 6 space-separated fields
+                    for (int i = 0; i < 6; i++) {
+                        ss >> tmp;
+                        fen += tmp + " ";
+                    }
+
+                    pos.parseFen(fen);
                 }
 
-                pos.parseFen(fen);
+                // Clear repetition table to avoid overflowing its index
+                engine.clearHistory();
             }
 
-            // Clear repetition table to avoid overflowing its index
-            engine.clearHistory();
-
             // Apply moves if present
-            std::string movesToken;
-            ss >> movesToken;
-
-            if (movesToken == "moves") {
-                std::string moveStr;
-                while (ss >> moveStr) {
-                    // add the hash BEFORE the move is made because search checks the hash against
-                    // the repetition table before examining any moves
-                    engine.addToHashHistory(pos.getHash());
-
-                    // decode UCI move and apply it
-                    Move m = Notation::uciToMove(pos, moveStr);
-                    pos.makeMove(m);
+            // N.B: appended moves only start with "moves" if the last command had none
+            bool readingMoves = extendsLast;
+            std::string moveStr;
+            while (ss >> moveStr) {
+                if (moveStr == "moves") {
+                    readingMoves = true;
+                    continue;
+                } else if (!readingMoves) {
+                    break;
                 }
+
+                // add the hash BEFORE the move is made because search checks the hash against
+                // the repetition table before examining any moves
+                engine.addToHashHistory(pos.getHash());
+
+                // decode UCI move and apply it
+                Move m = Notation::uciToMove(pos, moveStr);
+                pos.makeMove(m);
             }
+
+            lastPosition = line;
         }
 
         // -------- Go command --------
@@ -140,6 +231,16 @@ void UciFrontend::run() {
             // indexed by side to move, units are ms
             std::array<int, 2> time = {-1, -1};
             std::array<int, 2> inc = {0, 0};
+            TimeManager::Limits limits;
+            uint64_t nodes = 0;
+            int mate = 0;
+            bool ponder = false;
+            bool infiniteSearch = false;
+
+            // searchmoves lists moves until the next parameter, or the end of the command
+            std::vector<Move> searchMoves;
+            bool readingSearchMoves = false;
+            MoveList legalMoves;
 
             std::string token;
             while (ss >> token) {
@@ -153,6 +254,28 @@ void UciFrontend::run() {
                     ss >> inc[WHITE];
                 } else if (token == "binc") {
                     ss >> inc[BLACK];
+                } else if (token == "movestogo") {
+                    ss >> limits.movesToGo;
+                } else if (token == "movetime") {
+                    ss >> limits.moveTime;
+                } else if (token == "nodes") {
+                    ss >> nodes;
+                } else if (token == "mate") {
+                    ss >> mate;
+                } else if (token == "ponder") {
+                    ponder = true;
+                } else if (token == "infinite") {
+                    infiniteSearch = true;
+                } else if (token == "searchmoves") {
+                    readingSearchMoves = true;
+                    MoveGenerator::generateLegal(legalMoves, pos);
+                } else if (readingSearchMoves) {
+                    // N.B: illegal and unreadable moves are ignored
+                    for (const Move &move : legalMoves) {
+                        if (Notation::moveToUci(move) == token) {
+                            searchMoves.push_back(move);
+                        }
+                    }
                 }
             }
 
@@ -162,27 +285,77 @@ void UciFrontend::run() {
             }
 
             Color sideToMove = pos.getSideToMove();
-            if (time[sideToMove] != -1) {
-                // times provided; set up time management
-                int timeToMove = calculateTimeToMove(time[sideToMove], inc[sideToMove]);
-                timerStopper.setTimeLimit(timeToMove);
-                engine.setSearchStopper(&timerStopper);
+            limits.time = time[sideToMove];
+            limits.increment = inc[sideToMove];
+
+            // search stops at whichever limit is reached first, or on "stop" if there are none
+            searchLimits.clear();
+
+            // an infinite search ignores the clock and runs until "stop"
+            if (!infiniteSearch && (limits.time != -1 || limits.moveTime != -1)) {
+                // times provided; the stopwatch enforces the hard limit
+                timeManager.init(limits);
+                timerStopper.setTimeLimit(timeManager.getHardLimit());
+                searchLimits.add(&timerStopper);
+
+                // the limits are for after the opponent's move; "ponderhit" starts the clock
+                timeManager.setPaused(ponder);
+                timerStopper.setPaused(ponder);
+                engine.setTimeManager(&timeManager);
             } else {
-                // no time limit, use manual search stopper
-                engine.setSearchStopper(&manualStopper);
+                engine.setTimeManager(nullptr);
+            }
+
+            if (nodes > 0) {
+                nodeStopper.setNodeLimit(nodes);
+                searchLimits.add(&nodeStopper);
             }
 
+            if (mate > 0) {
+                mateStopper.setMateLimit(mate);
+                searchLimits.add(&mateStopper);
+            }
+
+            engine.setSearchMoves(searchMoves);
+
+            // N.B: reset here rather than on the search thread, so a "stop" sent right after
+            // this command is never undone by the search starting late
+            searchLimits.reset();
+
             {
                 std::lock_guard<std::mutex> lock(mtx);
                 searchDepth = depth;
+                pondering = ponder;
+                infinite = infiniteSearch;
+                hasSearchMoves = !searchMoves.empty();
             }
 
             // trigger the search worker to run
             cv.notify_one();
         }
 
+        // -------- Ponder hit --------
+        else if (cmd == "ponderhit") {
+            // the opponent played the expected move, so the ponder search becomes the real one
+            timeManager.setPaused(false);
+            timerStopper.setPaused(false);
+
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                pondering = false;
+            }
+            cv.notify_one();
+        }
+
         // -------- Stop command --------
         else if (cmd == "stop") {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                pondering = false;
+                infinite = false;
+            }
+            cv.notify_one();
+
             // this signals to the Searcher class to terminate ASAP
             engine.abortSearch();
         }
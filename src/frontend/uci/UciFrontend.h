@@ -1,20 +1,30 @@
 #include "src/ai/Engine.h"
-#include "src/ai/search/ManualSearchStopper.h"
+#include "src/ai/search/MateSearchStopper.h"
+#include "src/ai/search/NodeSearchStopper.h"
+#include "src/ai/search/SearchStopperGroup.h"
 #include "src/ai/search/SearchStopwatch.h"
+#include "src/ai/search/TimeManager.h"
 #include "src/core/Position.h"
 #include "src/core/types.h"
 
 #include <condition_variable>
 #include <mutex>
+#include <string>
 
 class UciFrontend {
    private:
     Engine engine;
     Position pos;
     SearchStopwatch timerStopper;
-    ManualSearchStopper manualStopper;
+    NodeSearchStopper nodeStopper;
+    MateSearchStopper mateStopper;
+    TimeManager timeManager;
 
-    // this mutex synchronizes writing to searchDepth
+    // the limits of the current "go" command; this is the engine's only stopper
+    SearchStopperGroup searchLimits;
+
+    // this mutex synchronizes writing to searchDepth, searching, pondering, infinite and
+    // hasSearchMoves
     std::mutex mtx;
 
     // this cv is used by the worker search thread to wait until a valid depth is received
@@ -24,19 +34,45 @@ class UciFrontend {
     // worker thread will wait until it is set to a positive value
     int searchDepth = -1;
 
+    // set from the time the worker takes a search until it has sent bestmove
+    bool searching = false;
+
+    // set by "go ponder" until "ponderhit" or "stop"; bestmove can't be sent while it is set
+    bool pondering = false;
+
+    // set by "go infinite" until "stop"; bestmove can't be sent while it is set
+    bool infinite = false;
+
+    // the book is skipped when "go searchmoves" restricts the root moves
+    bool hasSearchMoves = false;
+
     // only set to true when the "quit" command is received
     bool terminateWorker = false;
 
     bool useOwnBook = true;
 
+    static constexpr const char *DEFAULT_HASH_FILE = "sockfish.hash";
+
+    // where "savehash" and "loadhash" write and read the hash table
+    std::string hashFile = DEFAULT_HASH_FILE;
+
+    // the last "position" command; one that only appends moves to it applies just those
+    std::string lastPosition;
+
     void searchWorker();
 
-    // move this elsewhere?
-    int calculateTimeToMove(int remainingTime, int increment);
+    // whether a "go" command hasn't been answered with bestmove yet
+    bool isSearching();
 
    public:
     UciFrontend()
-        : engine(&manualStopper), pos(std::string(STARTING_POSITION_FEN)), timerStopper(1000) {}
+        : engine(&searchLimits),
+          pos(std::string(STARTING_POSITION_FEN)),
+          timerStopper(1000),
+          nodeStopper(SearchStopper::NO_NODE_LIMIT),
+          mateStopper(0) {
+        engine.setHashSize(TranspositionTable::DEFAULT_SIZE_MB);
+    }
 
     void run();
 };
@@ -11,10 +11,11 @@
 namespace MoveGenerator {
 
 // for reuse by MoveGen functions
-static Bitboard friendlyPieces = 0ull;
-static Bitboard enemyPieces = 0ull;
-static Bitboard occupiedSquares = 0ull;
-static Bitboard emptySquares = 0ull;
+// N.B: thread_local so that independent searches can generate moves concurrently
+static thread_local Bitboard friendlyPieces = 0ull;
+static thread_local Bitboard enemyPieces = 0ull;
+static thread_local Bitboard occupiedSquares = 0ull;
+static thread_local Bitboard emptySquares = 0ull;
 
 inline bool isMoveLegal(Position &pos, const Move &move) {
     // simulate move
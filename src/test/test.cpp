@@ -152,6 +152,7 @@ void getEvaluation(Position &pos, Evaluator &evaluator) {
 }
 
 void getBestMove(Position &pos, Engine &engine) {
+    engine.resetSearchStopper();
     Move m = engine.getMove(pos);
     printf("Best move: %s\n", Notation::moveToSAN(m, pos).c_str());
 }
@@ -183,7 +184,9 @@ int main() {
     Evaluator evaluator;
     SearchStopwatch stopper(10000);
     Engine engine(&stopper);
-    PolyglotBook openingBook;
+    // the engine's highest priority book
+    PolyglotBook openingBook(
+        std::string(DEFAULT_BOOK_FILES.substr(0, DEFAULT_BOOK_FILES.find(';'))));
     MoveGenerator::generateLegal(legalMoves, pos);
 
     while (1) {
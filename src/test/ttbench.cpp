@@ -0,0 +1,141 @@
+#include "src/core/MoveList.h"
+#include "src/core/PackedPosition.h"
+#include "src/core/Position.h"
+#include "src/movegen/MoveGenerator.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+/**
+ * Measures how often a transposition table mistakes one position for another
+ *
+ * Every node of a perft walk over the perft suite probes an always-replace table indexed by the
+ * low bits of the position's hash, like the engine's table. Slots also hold the position itself,
+ * so a probe whose stored key matches but whose position differs is a real collision. Keys can be
+ * truncated to measure collisions at a rate where good keys show some, which should be close to
+ * the rate expected from perfectly random keys
+ */
+struct Slot {
+    uint64_t key = 0;
+    PackedPosition pos {};
+    bool used = false;
+};
+
+struct Stats {
+    uint64_t probes = 0;
+
+    // same key and same position
+    uint64_t hits = 0;
+
+    // same key, different position
+    uint64_t collisions = 0;
+
+    // slot held a different position, so a collision was possible
+    uint64_t contested = 0;
+};
+
+class CollisionTable {
+   private:
+    std::vector<Slot> slots;
+
+    uint64_t indexMask;
+
+    uint64_t keyMask;
+
+   public:
+    CollisionTable(int indexBits, int keyBits)
+        : slots(size_t(1) << indexBits),
+          indexMask((uint64_t(1) << indexBits) - 1),
+          keyMask(keyBits >= 64 ? ~0ull : (uint64_t(1) << keyBits) - 1) {}
+
+    void probe(const Position &pos, Stats &stats) {
+        const uint64_t key = pos.getHash() & keyMask;
+        Slot &slot = slots[key & indexMask];
+
+        // N.B: the hash leaves out the halfmove clock and en passant squares that can't be
+        // captured, so transpositions may differ in them
+        PackedPosition packed = pos.pack();
+        packed.halfmoveClock = 0;
+        if (!pos.hasEnPassantCapture()) {
+            packed.enPassantSquare = NO_SQ;
+        }
+
+        stats.probes++;
+        if (slot.used && std::memcmp(&slot.pos, &packed, sizeof(PackedPosition)) != 0) {
+            stats.contested++;
+            if (slot.key == key) {
+                stats.collisions++;
+            }
+        } else if (slot.used) {
+            stats.hits++;
+        }
+
+        slot = {key, packed, true};
+    }
+};
+
+void walk(Position &pos, int depth, CollisionTable &table, Stats &stats) {
+    table.probe(pos, stats);
+
+    if (depth == 0) {
+        return;
+    }
+
+    MoveList moves;
+    MoveGenerator::generateLegal(moves, pos);
+
+    for (const Move &m : moves) {
+        Position::Metadata md = pos.makeMove(m);
+        walk(pos, depth - 1, table, stats);
+        pos.unmakeMove(m, md);
+    }
+}
+
+int main(int argc, char **argv) {
+    const int depth = argc > 1 ? std::stoi(argv[1]) : 3;
+    const int indexBits = argc > 2 ? std::stoi(argv[2]) : 20;
+    const int keyBits = argc > 3 ? std::stoi(argv[3]) : 64;
+
+    if (keyBits < indexBits || keyBits > 64) {
+        std::cerr << "Usage: ./ttbench [depth] [index bits] [key bits]\n";
+        return 1;
+    }
+
+    std::ifstream file("../src/test/perft.in");
+    if (!file) {
+        std::cerr << "Failed to open perft file\n";
+        return 1;
+    }
+
+    CollisionTable table(indexBits, keyBits);
+    Stats stats;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::stringstream ss(line);
+        std::string fen;
+        std::getline(ss, fen, ';');
+
+        Position pos(fen);
+        walk(pos, depth, table, stats);
+    }
+
+    // random keys collide once per 2^(key bits - index bits) contested probes
+    const double expected = stats.contested / std::pow(2.0, keyBits - indexBits);
+
+    std::cout << "Depth " << depth << ", 2^" << indexBits << " slots, " << keyBits << " bit keys\n"
+              << "  probes:     " << stats.probes << '\n'
+              << "  hits:       " << stats.hits << '\n'
+              << "  contested:  " << stats.contested << '\n'
+              << "  collisions: " << stats.collisions << " (" << expected << " expected)\n";
+
+    return 0;
+}
@@ -0,0 +1,559 @@
+#include "Tuner.h"
+
+#include "src/ai/EvalParams.h"
+#include "src/ai/Evaluator.h"
+#include "src/bitboard/bit_tools.h"
+#include "src/core/AttackMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+static constexpr Tuner::PhaseScale getPhaseScale(int index) {
+    if (index >= Tuner::MG_PSQT_OFFSET && index < Tuner::EG_PSQT_OFFSET) {
+        return Tuner::PSQT_MIDGAME;
+    } else if (index >= Tuner::EG_PSQT_OFFSET && index < Tuner::PASSED_PAWN) {
+        return Tuner::PSQT_ENDGAME;
+    } else if (index >= Tuner::KING_ATTACK_OFFSET) {
+        return Tuner::MIDGAME;
+    }
+    return Tuner::UNSCALED;
+}
+
+// looked up once per feature per epoch, so it's precomputed
+static constexpr std::array<Tuner::PhaseScale, Tuner::NUM_PARAMS> PHASE_SCALES = [] {
+    std::array<Tuner::PhaseScale, Tuner::NUM_PARAMS> scales {};
+    for (int i = 0; i < Tuner::NUM_PARAMS; i++) {
+        scales[i] = getPhaseScale(i);
+    }
+    return scales;
+}();
+
+Tuner::Tuner(int numThreads)
+    : params(getInitialParams()), numThreads(std::max(1, numThreads)) {}
+
+std::array<double, Tuner::NUM_PARAMS> Tuner::getInitialParams() {
+    std::array<double, NUM_PARAMS> p {};
+
+    for (PieceType pt : PIECE_TYPES) {
+        p[MATERIAL_OFFSET + pt] = EvalParams::MATERIAL_VALUES[pt];
+        p[MOBILITY_OFFSET + pt] = EvalParams::MOBILITY_BONUS[pt];
+        p[KING_ATTACK_OFFSET + pt] = EvalParams::KING_ATTACK_BONUS[pt];
+
+        for (Square sq : ALL_SQUARES) {
+            p[MG_PSQT_OFFSET + pt * NO_SQ + sq] = EvalParams::MIDDLEGAME_PSQT[pt][sq];
+            p[EG_PSQT_OFFSET + pt * NO_SQ + sq] = EvalParams::ENDGAME_PSQT[pt][sq];
+        }
+    }
+
+    p[PASSED_PAWN] = EvalParams::PASSED_PAWN_BONUS;
+    p[PROTECTED_PASSED_PAWN] = EvalParams::PROTECTED_PASSED_PAWN_BONUS;
+    p[DOUBLED_PAWNS] = EvalParams::DOUBLED_PAWNS_PENALTY;
+    p[SEMI_OPEN_FILE] = EvalParams::SEMI_OPEN_FILE_BONUS;
+    p[OPEN_FILE] = EvalParams::OPEN_FILE_BONUS;
+    p[KING_DISTANCE] = EvalParams::KING_DISTANCE_BONUS;
+
+    return p;
+}
+
+// N.B: this must stay in sync with Evaluator::run
+double Tuner::extractFeatures(const Position &pos, std::vector<Feature> &out, Sample &sample) {
+    // dense scratch space, reset after each position by walking the touched list
+    thread_local std::array<int, NUM_PARAMS> coefs {};
+    thread_local std::vector<int> touched;
+
+    auto add = [&](int index, int amount) {
+        if (coefs[index] == 0) {
+            touched.push_back(index);
+        }
+        coefs[index] += amount;
+    };
+
+    // same phase blend as Evaluator::getPsqtEval and Evaluator::getKingSafetyEval
+    const float endgameWeight = Evaluator::getEndgameWeight(pos);
+    const int eg = int(endgameWeight * 256);
+    const int mg = 256 - eg;
+
+    sample.scales[UNSCALED] = 1.0f;
+    sample.scales[PSQT_MIDGAME] = Evaluator::PSQT_WEIGHT * mg / 256.0f;
+    sample.scales[PSQT_ENDGAME] = Evaluator::PSQT_WEIGHT * eg / 256.0f;
+    sample.scales[MIDGAME] = mg / 256.0f;
+
+    const Bitboard whitePawns = pos.getPieceBB(WP);
+    const Bitboard blackPawns = pos.getPieceBB(BP);
+
+    for (Piece p : ALL_PIECES) {
+        const PieceType pt = pieceToPT(p);
+        const Color c = pieceColor(p);
+        const int sign = SIGN[c];
+        const Bitboard ownPawns = c == WHITE ? whitePawns : blackPawns;
+        const Bitboard enemyPawns = c == WHITE ? blackPawns : whitePawns;
+
+        forEachSquare(pos.getPieceBB(p), [&](Square sq) {
+            // PSQTs are stored from white's perspective
+            const Square psqtSq = c == WHITE ? sq : flipRank(sq);
+
+            add(MATERIAL_OFFSET + pt, sign);
+            add(MG_PSQT_OFFSET + pt * NO_SQ + psqtSq, sign);
+            add(EG_PSQT_OFFSET + pt * NO_SQ + psqtSq, sign);
+
+            if (pt == PAWN) {
+                if ((Evaluator::PASSED_PAWN_BLOCKER_MASKS[c][sq] & enemyPawns) == 0) {
+                    add(PASSED_PAWN, sign);
+                    if (PAWN_ATTACK_MASKS[otherColor(c)][sq] & ownPawns) {
+                        add(PROTECTED_PASSED_PAWN, sign);
+                    }
+                }
+
+                const int numPawnsOnFile = getBitCount(FILE_MASKS[fileOf(sq)] & ownPawns);
+                if (numPawnsOnFile > 1) {
+                    add(DOUBLED_PAWNS, -sign * numPawnsOnFile);
+                }
+            }
+
+            if (pt == ROOK && (FILE_MASKS[fileOf(sq)] & enemyPawns) == 0) {
+                add(SEMI_OPEN_FILE, sign);
+                if ((FILE_MASKS[fileOf(sq)] & ownPawns) == 0) {
+                    add(OPEN_FILE, sign);
+                }
+            }
+        });
+    }
+
+    // king distance is added from white's perspective regardless of side to move
+    if (endgameWeight > Evaluator::KING_DISTANCE_CUTOFF) {
+        const Square kingSq1 = pos.getKingSquare(WHITE), kingSq2 = pos.getKingSquare(BLACK);
+        const int width = std::abs(fileOf(kingSq1) - fileOf(kingSq2));
+        const int height = std::abs(rankOf(kingSq1) - rankOf(kingSq2));
+        add(KING_DISTANCE, 7 - std::max(width, height));
+    }
+
+    const AttackMap attackMap(pos);
+    for (PieceType pt : PIECE_TYPES) {
+        add(MOBILITY_OFFSET + pt, attackMap.mobility[WHITE][pt] - attackMap.mobility[BLACK][pt]);
+        add(KING_ATTACK_OFFSET + pt,
+            attackMap.kingZoneAttacks[WHITE][pt] - attackMap.kingZoneAttacks[BLACK][pt]);
+    }
+
+    // flush the scratch space into the compact representation
+    static const std::array<double, NUM_PARAMS> initial = getInitialParams();
+    double eval = 0.0;
+
+    sample.begin = out.size();
+    for (int index : touched) {
+        if (coefs[index] != 0) {
+            const int16_t coef = std::clamp(coefs[index], INT16_MIN, INT16_MAX);
+            out.push_back({uint16_t(index), coef});
+            eval += coef * initial[index] * sample.scales[PHASE_SCALES[index]];
+        }
+        coefs[index] = 0;
+    }
+    sample.end = out.size();
+    touched.clear();
+
+    return eval;
+}
+
+// returns true and sets result if line contains a recognizable game result
+static bool parseResult(const std::string &line, float &result, size_t &fenEnd) {
+    static constexpr std::array<std::pair<std::string_view, float>, 8> MARKERS = {{
+        {"[1.0]", 1.0f},
+        {"[0.5]", 0.5f},
+        {"[0.0]", 0.0f},
+        {"[1]", 1.0f},
+        {"[0]", 0.0f},
+        {"1/2-1/2", 0.5f},
+        {"1-0", 1.0f},
+        {"0-1", 0.0f},
+    }};
+
+    for (auto [marker, value] : MARKERS) {
+        const size_t at = line.rfind(marker);
+        if (at != std::string::npos) {
+            result = value;
+            fenEnd = at;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Tuner::extractChunk(size_t count, const Decoder &decode, double &totalDrift, size_t &skipped) {
+    std::vector<std::vector<Sample>> threadSamples(numThreads);
+    std::vector<std::vector<Feature>> threadFeatures(numThreads);
+    std::vector<double> threadDrift(numThreads, 0.0);
+    std::vector<size_t> threadSkipped(numThreads, 0);
+
+    auto worker = [&](int t) {
+        Position pos;
+        Evaluator evaluator;
+
+        for (size_t i = t; i < count; i += numThreads) {
+            Sample sample;
+            if (!decode(i, pos, sample.result)) {
+                threadSkipped[t]++;
+                continue;
+            }
+
+            const double tracedEval = extractFeatures(pos, threadFeatures[t], sample);
+            threadSamples[t].push_back(sample);
+
+            // compare against the real evaluator to catch drift between the two
+            const Eval realEval = SIGN[pos.getSideToMove()] * evaluator.run(pos);
+            threadDrift[t] += std::abs(tracedEval - realEval);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back(worker, t);
+    }
+    for (std::thread &th : threads) {
+        th.join();
+    }
+
+    // append in thread order, rebasing each sample's feature range
+    for (int t = 0; t < numThreads; t++) {
+        const uint32_t base = features.size();
+        for (Sample s : threadSamples[t]) {
+            s.begin += base;
+            s.end += base;
+            samples.push_back(s);
+        }
+        features.insert(features.end(), threadFeatures[t].begin(), threadFeatures[t].end());
+        totalDrift += threadDrift[t];
+        skipped += threadSkipped[t];
+    }
+}
+
+size_t Tuner::loadPositions(const std::string &path) {
+    const bool isPacked = std::filesystem::path(path).extension() == ".bin";
+
+    std::ifstream file(path, isPacked ? std::ios::binary : std::ios::in);
+    if (!file) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return 0;
+    }
+
+    // positions are read in chunks so that feature extraction can run on every thread without
+    // holding the whole file in memory
+    static constexpr size_t CHUNK_SIZE = 1 << 16;
+
+    double totalDrift = 0.0;
+    size_t skipped = 0;
+
+    if (isPacked) {
+        std::vector<PackedPosition> records(CHUNK_SIZE);
+
+        auto decode = [&](size_t i, Position &pos, float &result) {
+            // N.B: corrupt records are skipped rather than trusted
+            if (records[i].result > 2 || !pos.unpack(records[i])) {
+                return false;
+            }
+
+            result = records[i].result / 2.0f;
+            return true;
+        };
+
+        while (file.read(reinterpret_cast<char *>(records.data()),
+                         CHUNK_SIZE * sizeof(PackedPosition)) ||
+               file.gcount() > 0) {
+            extractChunk(file.gcount() / sizeof(PackedPosition), decode, totalDrift, skipped);
+        }
+    } else {
+        std::vector<std::string> lines;
+        lines.reserve(CHUNK_SIZE);
+
+        auto decode = [&](size_t i, Position &pos, float &result) {
+            size_t fenEnd;
+            if (!parseResult(lines[i], result, fenEnd)) {
+                return false;
+            }
+
+            // keep the board, side, castling, and en passant fields
+            std::istringstream ss(lines[i].substr(0, fenEnd));
+            std::string field, fen;
+            for (int f = 0; f < 4 && ss >> field; f++) {
+                fen += field + " ";
+            }
+            pos.parseFen(fen + "0 1");
+            return true;
+        };
+
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(std::move(line));
+            if (lines.size() == CHUNK_SIZE) {
+                extractChunk(lines.size(), decode, totalDrift, skipped);
+                lines.clear();
+            }
+        }
+        extractChunk(lines.size(), decode, totalDrift, skipped);
+    }
+
+    if (skipped > 0) {
+        std::cerr << "Skipped " << skipped << " positions without a result" << std::endl;
+    }
+
+    if (!samples.empty()) {
+        std::cout << "Mean |feature eval - Evaluator::run|: " << totalDrift / samples.size()
+                  << " cp" << std::endl;
+    }
+
+    return samples.size();
+}
+
+double Tuner::evaluate(const Sample &sample) const {
+    double eval = 0.0;
+    for (uint32_t i = sample.begin; i < sample.end; i++) {
+        const Feature &f = features[i];
+        eval += f.coef * params[f.index] * sample.scales[PHASE_SCALES[f.index]];
+    }
+    return eval;
+}
+
+static inline double sigmoid(double k, double eval) {
+    return 1.0 / (1.0 + std::pow(10.0, -k * eval / 400.0));
+}
+
+double Tuner::computeError(double k) const {
+    std::vector<double> threadErrors(numThreads, 0.0);
+
+    auto worker = [&](int t) {
+        double error = 0.0;
+        for (size_t i = t; i < samples.size(); i += numThreads) {
+            const double diff = samples[i].result - sigmoid(k, evaluate(samples[i]));
+            error += diff * diff;
+        }
+        threadErrors[t] = error;
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back(worker, t);
+    }
+    for (std::thread &th : threads) {
+        th.join();
+    }
+
+    double total = 0.0;
+    for (double e : threadErrors) {
+        total += e;
+    }
+    return total / samples.size();
+}
+
+void Tuner::computeOptimalK() {
+    // narrow in on the best k one decimal place at a time
+    double start = 0.0, end = 3.0, step = 0.1;
+    double best = computeError(k);
+
+    for (int precision = 0; precision < 5; precision++) {
+        for (double candidate = start; candidate <= end; candidate += step) {
+            const double error = computeError(candidate);
+            if (error < best) {
+                best = error;
+                k = candidate;
+            }
+        }
+
+        start = k - step;
+        end = k + step;
+        step /= 10.0;
+    }
+
+    std::cout << "Optimal K: " << k << " (error " << best << ")" << std::endl;
+}
+
+void Tuner::computeGradient(std::vector<double> &gradient) const {
+    std::vector<std::vector<double>> threadGradients(numThreads,
+                                                     std::vector<double>(NUM_PARAMS, 0.0));
+
+    // samples are split into contiguous slices so each thread streams through memory
+    const size_t sliceSize = (samples.size() + numThreads - 1) / numThreads;
+
+    auto worker = [&](int t) {
+        std::vector<double> &g = threadGradients[t];
+        const size_t first = t * sliceSize;
+        const size_t last = std::min(samples.size(), first + sliceSize);
+
+        for (size_t i = first; i < last; i++) {
+            const Sample &sample = samples[i];
+            const double s = sigmoid(k, evaluate(sample));
+
+            // derivative of (result - s)^2 w.r.t. eval, minus constant factors
+            const double term = (s - sample.result) * s * (1.0 - s);
+
+            for (uint32_t j = sample.begin; j < sample.end; j++) {
+                const Feature &f = features[j];
+                g[f.index] += term * f.coef * sample.scales[PHASE_SCALES[f.index]];
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back(worker, t);
+    }
+    for (std::thread &th : threads) {
+        th.join();
+    }
+
+    std::fill(gradient.begin(), gradient.end(), 0.0);
+    for (const std::vector<double> &g : threadGradients) {
+        for (int i = 0; i < NUM_PARAMS; i++) {
+            gradient[i] += g[i];
+        }
+    }
+}
+
+void Tuner::run(int epochs, double learningRate) {
+    static constexpr double BETA1 = 0.9, BETA2 = 0.999, EPSILON = 1e-8;
+
+    if (samples.empty()) {
+        return;
+    }
+
+    std::vector<double> gradient(NUM_PARAMS), m(NUM_PARAMS, 0.0), v(NUM_PARAMS, 0.0);
+
+    for (int epoch = 1; epoch <= epochs; epoch++) {
+        computeGradient(gradient);
+
+        // Adam: https://arxiv.org/abs/1412.6980
+        const double correction1 = 1.0 - std::pow(BETA1, epoch);
+        const double correction2 = 1.0 - std::pow(BETA2, epoch);
+        for (int i = 0; i < NUM_PARAMS; i++) {
+            const double g = gradient[i] / samples.size();
+            m[i] = BETA1 * m[i] + (1.0 - BETA1) * g;
+            v[i] = BETA2 * v[i] + (1.0 - BETA2) * g * g;
+            params[i] -=
+                learningRate * (m[i] / correction1) / (std::sqrt(v[i] / correction2) + EPSILON);
+        }
+
+        if (epoch % 50 == 0 || epoch == epochs) {
+            std::cout << "Epoch " << epoch << ": error " << computeError(k) << std::endl;
+        }
+    }
+}
+
+static void writeTable(std::ofstream &out,
+                       const std::string &name,
+                       const std::array<double, Tuner::NUM_PARAMS> &params,
+                       int offset) {
+    static constexpr std::array<std::string_view, NO_PT> PT_NAMES = {"PAWN", "KNIGHT", "BISHOP",
+                                                                     "ROOK", "QUEEN",  "KING"};
+
+    out << "constexpr std::array<std::array<Eval, NO_SQ>, NO_PT> " << name << " = {\n";
+    for (PieceType pt : PIECE_TYPES) {
+        out << "    // " << PT_NAMES[pt] << "\n";
+        out << "    std::array {\n";
+        for (int rank = 0; rank < 8; rank++) {
+            out << "     ";
+            for (int file = 0; file < 8; file++) {
+                const int value = std::lround(params[offset + pt * NO_SQ + rank * 8 + file]);
+                out << (value < 0 ? '-' : '+') << std::setw(2) << std::setfill('0')
+                    << std::abs(value) << (file < 7 ? ", " : "");
+            }
+            out << (rank < 7 ? ",\n" : "\n");
+        }
+        out << (pt < KING ? "    },\n" : "    }\n");
+    }
+    out << "};\n";
+}
+
+static std::string formatArray(const std::array<double, Tuner::NUM_PARAMS> &params, int offset) {
+    std::ostringstream ss;
+    ss << "{";
+    for (PieceType pt : PIECE_TYPES) {
+        ss << std::lround(params[offset + pt]) << (pt < KING ? ", " : "");
+    }
+    ss << "}";
+    return ss.str();
+}
+
+void Tuner::writeHeader(const std::string &path) const {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return;
+    }
+
+    auto value = [&](int index) { return std::lround(params[index]); };
+
+    out << "#pragma once\n"
+           "\n"
+           "// Tunable evaluation parameters. This file is regenerated by the tune target, so keep "
+           "hand edits\n"
+           "// in the same format. PSQTs are written from white's perspective; Evaluator mirrors "
+           "them for black\n"
+           "\n"
+           "#include \"src/core/types.h\"\n"
+           "\n"
+           "#include <array>\n"
+           "\n"
+           "namespace EvalParams {\n"
+           "\n"
+           "// PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING\n"
+           "constexpr std::array<Eval, NO_PT> MATERIAL_VALUES = "
+        << formatArray(params, MATERIAL_OFFSET)
+        << ";\n"
+           "\n"
+           "// clang-format off\n";
+
+    writeTable(out, "MIDDLEGAME_PSQT", params, MG_PSQT_OFFSET);
+    out << "\n";
+    writeTable(out, "ENDGAME_PSQT", params, EG_PSQT_OFFSET);
+
+    out << "// clang-format on\n"
+           "\n"
+           "// N.B: Protected passed pawns reward the sum of these bonuses\n"
+           "constexpr Eval PASSED_PAWN_BONUS = "
+        << value(PASSED_PAWN)
+        << ";\n"
+           "constexpr Eval PROTECTED_PASSED_PAWN_BONUS = "
+        << value(PROTECTED_PASSED_PAWN)
+        << ";\n"
+           "\n"
+           "// N.B: This gets multiplied by the number of pawns doubled on a file\n"
+           "constexpr Eval DOUBLED_PAWNS_PENALTY = "
+        << value(DOUBLED_PAWNS)
+        << ";\n"
+           "\n"
+           "// N.B: Rooks on open files reward the sum of these bonuses\n"
+           "constexpr Eval SEMI_OPEN_FILE_BONUS = "
+        << value(SEMI_OPEN_FILE)
+        << ";\n"
+           "constexpr Eval OPEN_FILE_BONUS = "
+        << value(OPEN_FILE)
+        << ";\n"
+           "\n"
+           "// N.B: This gets multiplied by how many king moves closer than 7 the two kings are\n"
+           "constexpr Eval KING_DISTANCE_BONUS = "
+        << value(KING_DISTANCE)
+        << ";\n"
+           "\n"
+           "// N.B: These get multiplied by the number of safe squares a piece attacks\n"
+           "// PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING\n"
+           "constexpr std::array<Eval, NO_PT> MOBILITY_BONUS = "
+        << formatArray(params, MOBILITY_OFFSET)
+        << ";\n"
+           "\n"
+           "// N.B: These get multiplied by the number of squares around the enemy king a piece "
+           "attacks,\n"
+           "// then scaled down as the game approaches the endgame\n"
+           "// PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING\n"
+           "constexpr std::array<Eval, NO_PT> KING_ATTACK_BONUS = "
+        << formatArray(params, KING_ATTACK_OFFSET)
+        << ";\n"
+           "\n"
+           "}  // namespace EvalParams\n";
+
+    std::cout << "Wrote " << path << std::endl;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "src/core/Position.h"
+#include "src/core/types.h"
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Texel tuner for the parameters in EvalParams.h
+ * https://www.chessprogramming.org/Texel%27s_Tuning_Method
+ *
+ * Every position is reduced once, at load time, to a sparse list of (parameter, coefficient)
+ * pairs such that the white-relative eval is the sum of coefficient * parameter * phase scale.
+ * Each epoch then only walks those flat arrays instead of running the Evaluator
+ */
+class Tuner {
+   public:
+    // index of each parameter in the flat parameter vector
+    enum ParamIndex : int {
+        MATERIAL_OFFSET = 0,
+        MG_PSQT_OFFSET = MATERIAL_OFFSET + NO_PT,
+        EG_PSQT_OFFSET = MG_PSQT_OFFSET + NO_PT * NO_SQ,
+        PASSED_PAWN = EG_PSQT_OFFSET + NO_PT * NO_SQ,
+        PROTECTED_PASSED_PAWN,
+        DOUBLED_PAWNS,
+        SEMI_OPEN_FILE,
+        OPEN_FILE,
+        KING_DISTANCE,
+        MOBILITY_OFFSET,
+        KING_ATTACK_OFFSET = MOBILITY_OFFSET + NO_PT,
+        NUM_PARAMS = KING_ATTACK_OFFSET + NO_PT
+    };
+
+    // how each parameter is scaled by the game phase of a position
+    enum PhaseScale : uint8_t { UNSCALED, PSQT_MIDGAME, PSQT_ENDGAME, MIDGAME, NUM_SCALES };
+
+   private:
+    // 4 bytes per feature keeps an epoch's working set small and sequential
+    struct Feature {
+        uint16_t index;
+        int16_t coef;
+    };
+
+    struct Sample {
+        // game result from white's perspective: 1, 0.5, or 0
+        float result;
+
+        // multiplier for each PhaseScale in this position
+        std::array<float, NUM_SCALES> scales;
+
+        // range of this sample's features in the features vector
+        uint32_t begin, end;
+    };
+
+    std::vector<Sample> samples;
+
+    std::vector<Feature> features;
+
+    std::array<double, NUM_PARAMS> params;
+
+    int numThreads;
+
+    // sigmoid scaling constant that maps evals to expected scores
+    double k = 1.0;
+
+    static std::array<double, NUM_PARAMS> getInitialParams();
+
+    // appends pos's features to out and fills in the sample's scales; returns the white-relative
+    // eval those features produce with the initial parameters, for sanity checking
+    static double extractFeatures(const Position &pos, std::vector<Feature> &out, Sample &sample);
+
+    // loads the ith position of the current chunk and its result, or returns false to skip it
+    using Decoder = std::function<bool(size_t i, Position &pos, float &result)>;
+
+    // extracts features from count positions on every thread and appends them in order
+    void extractChunk(size_t count, const Decoder &decode, double &totalDrift, size_t &skipped);
+
+    double evaluate(const Sample &sample) const;
+
+    double computeError(double k) const;
+
+    void computeGradient(std::vector<double> &gradient) const;
+
+   public:
+    Tuner(int numThreads);
+
+    /**
+     * Loads labelled positions, either
+     * - a .bin file of PackedPosition records with results, as written by datagen, or
+     * - a text file with one position per line, where each line is a FEN followed by a result in
+     *   any of the usual forms: 1-0, 0-1, 1/2-1/2, [1.0], [0.5], [0.0]
+     *
+     * @return the number of positions loaded
+     */
+    size_t loadPositions(const std::string &path);
+
+    // finds the sigmoid scaling constant that best fits the current parameters
+    void computeOptimalK();
+
+    /**
+     * Runs full-batch gradient descent (Adam) on the loaded positions
+     *
+     * @param epochs number of passes over the data
+     * @param learningRate step size, in centipawns
+     */
+    void run(int epochs, double learningRate);
+
+    // writes the current parameters as a replacement for src/ai/EvalParams.h
+    void writeHeader(const std::string &path) const;
+};
@@ -0,0 +1,49 @@
+#include "src/tune/Tuner.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: ./tune <positions file> [epochs] [learning rate] [output header]\n"
+                     "The positions file is either a .bin file written by datagen, or text where\n"
+                     "each line is a FEN followed by a game result, e.g.\n"
+                     "  rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1 [0.5]"
+                  << std::endl;
+        return 1;
+    }
+
+    const std::string input = argv[1];
+    const int epochs = argc > 2 ? std::stoi(argv[2]) : 1000;
+    const double learningRate = argc > 3 ? std::stod(argv[3]) : 1.0;
+    const std::string output = argc > 4 ? argv[4] : "EvalParams.h";
+
+    Tuner tuner(std::thread::hardware_concurrency());
+
+    auto start = std::chrono::steady_clock::now();
+    const size_t numPositions = tuner.loadPositions(input);
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "Loaded " << numPositions << " positions in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << " ms" << std::endl;
+
+    if (numPositions == 0) {
+        return 1;
+    }
+
+    tuner.computeOptimalK();
+
+    start = std::chrono::steady_clock::now();
+    tuner.run(epochs, learningRate);
+    end = std::chrono::steady_clock::now();
+
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Ran " << epochs << " epochs in " << ms << " ms" << std::endl;
+
+    tuner.writeHeader(output);
+
+    return 0;
+}
@@ -1,6 +1,18 @@
+#include "src/frontend/uci/Bench.h"
 #include "src/frontend/uci/UciFrontend.h"
 
-int main() {
+#include <string>
+
+int main(int argc, char **argv) {
+    // ./sockfish bench [depth] [threads] [hash]
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        const int depth = argc > 2 ? std::stoi(argv[2]) : Bench::DEFAULT_DEPTH;
+        const int threads = argc > 3 ? std::stoi(argv[3]) : 1;
+        const size_t hashMb = argc > 4 ? std::stoull(argv[4]) : TranspositionTable::DEFAULT_SIZE_MB;
+
+        return Bench::run(depth, threads, hashMb) ? 0 : 1;
+    }
+
     UciFrontend uci;
     uci.run();
 